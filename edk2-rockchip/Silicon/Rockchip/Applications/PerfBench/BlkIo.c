@@ -0,0 +1,223 @@
+/** @file
+ *
+ *  Block I/O read throughput benchmark.
+ *
+ *  Reads SizeMiB (default 256) MiB sequentially from the start of the given
+ *  Block I/O instance (default 0) in ChunkKiB (default 1024) KiB requests,
+ *  and reports the achieved throughput. Without a matching instance, the
+ *  available ones are listed.
+ *
+ *  Copyright (c) 2026, Rockchip Limited. All rights reserved.
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#include <Library/BaseLib.h>
+#include <Library/DevicePathLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/TimerLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/UefiLib.h>
+#include <Protocol/BlockIo.h>
+
+#include "PerfBench.h"
+
+#define BLKIO_BENCH_DEFAULT_SIZE_MIB   256
+#define BLKIO_BENCH_DEFAULT_CHUNK_KIB  1024
+
+STATIC
+VOID
+BlkIoBenchListDevices (
+  IN EFI_HANDLE  *Handles,
+  IN UINTN       HandleCount
+  )
+{
+  EFI_STATUS             Status;
+  EFI_BLOCK_IO_PROTOCOL  *BlockIo;
+  CHAR16                 *DevicePathText;
+  UINTN                  Index;
+
+  for (Index = 0; Index < HandleCount; Index++) {
+    Status = gBS->HandleProtocol (
+                    Handles[Index],
+                    &gEfiBlockIoProtocolGuid,
+                    (VOID **)&BlockIo
+                    );
+    if (EFI_ERROR (Status)) {
+      continue;
+    }
+
+    DevicePathText = ConvertDevicePathToText (DevicePathFromHandle (Handles[Index]), TRUE, TRUE);
+
+    Print (
+      L"%3lu: %a%5lu MiB %s\n",
+      (UINT64)Index,
+      BlockIo->Media->LogicalPartition ? "part " : "disk ",
+      RShiftU64 (MultU64x32 (BlockIo->Media->LastBlock + 1, BlockIo->Media->BlockSize), 20),
+      DevicePathText != NULL ? DevicePathText : L"?"
+      );
+
+    if (DevicePathText != NULL) {
+      FreePool (DevicePathText);
+    }
+  }
+}
+
+EFI_STATUS
+BenchBlockIoRead (
+  IN UINTN   Argc,
+  IN CHAR16  **Argv
+  )
+{
+  EFI_STATUS             Status;
+  EFI_BLOCK_IO_PROTOCOL  *BlockIo;
+  EFI_BLOCK_IO_MEDIA     *Media;
+  EFI_HANDLE             *Handles;
+  UINTN                  HandleCount;
+  UINTN                  BlockIoIndex;
+  UINT64                 SizeMiB;
+  UINTN                  ChunkKiB;
+  UINTN                  ChunkSize;
+  UINTN                  ChunkBlocks;
+  UINT64                 TotalBytes;
+  UINT64                 ReadBytes;
+  UINT64                 MediaBytes;
+  EFI_LBA                Lba;
+  UINTN                  Requests;
+  VOID                   *Buffer;
+  VOID                   *AlignedBuffer;
+  UINTN                  IoAlign;
+  UINT64                 Start;
+  UINT64                 ElapsedNs;
+
+  SizeMiB      = BLKIO_BENCH_DEFAULT_SIZE_MIB;
+  BlockIoIndex = 0;
+  ChunkKiB     = BLKIO_BENCH_DEFAULT_CHUNK_KIB;
+
+  if (Argc > 1) {
+    SizeMiB = StrDecimalToUint64 (Argv[1]);
+  }
+
+  if (Argc > 2) {
+    BlockIoIndex = StrDecimalToUintn (Argv[2]);
+  }
+
+  if (Argc > 3) {
+    ChunkKiB = StrDecimalToUintn (Argv[3]);
+  }
+
+  if ((SizeMiB == 0) || (ChunkKiB == 0)) {
+    Print (L"Size and chunk size must not be 0\n");
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Status = gBS->LocateHandleBuffer (
+                  ByProtocol,
+                  &gEfiBlockIoProtocolGuid,
+                  NULL,
+                  &HandleCount,
+                  &Handles
+                  );
+  if (EFI_ERROR (Status)) {
+    Print (L"No Block I/O instances found\n");
+    return EFI_NOT_FOUND;
+  }
+
+  if (BlockIoIndex >= HandleCount) {
+    Print (L"Block I/O instance %lu not found, available instances:\n", (UINT64)BlockIoIndex);
+    BlkIoBenchListDevices (Handles, HandleCount);
+    FreePool (Handles);
+    return EFI_NOT_FOUND;
+  }
+
+  Status = gBS->HandleProtocol (
+                  Handles[BlockIoIndex],
+                  &gEfiBlockIoProtocolGuid,
+                  (VOID **)&BlockIo
+                  );
+  FreePool (Handles);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Media = BlockIo->Media;
+  if (!Media->MediaPresent || (Media->BlockSize == 0)) {
+    Print (L"No media present\n");
+    return EFI_NO_MEDIA;
+  }
+
+  ChunkSize = ChunkKiB * SIZE_1KB;
+  if ((ChunkSize % Media->BlockSize) != 0) {
+    Print (L"Chunk size must be a multiple of the block size (%u)\n", Media->BlockSize);
+    return EFI_INVALID_PARAMETER;
+  }
+
+  ChunkBlocks = ChunkSize / Media->BlockSize;
+
+  MediaBytes = MultU64x32 (Media->LastBlock + 1, Media->BlockSize);
+  TotalBytes = LShiftU64 (SizeMiB, 20);
+  if (TotalBytes > MediaBytes) {
+    TotalBytes = MediaBytes - (MediaBytes % ChunkSize);
+  }
+
+  if (TotalBytes == 0) {
+    Print (L"Media is smaller than the chunk size\n");
+    return EFI_INVALID_PARAMETER;
+  }
+
+  IoAlign = MAX (Media->IoAlign, 1);
+  Buffer  = AllocatePool (ChunkSize + IoAlign - 1);
+  if (Buffer == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  AlignedBuffer = (VOID *)ALIGN_VALUE ((UINTN)Buffer, IoAlign);
+
+  Print (
+    L"Reading %lu MiB from Block I/O %lu in %lu KiB requests...\n",
+    RShiftU64 (TotalBytes, 20),
+    (UINT64)BlockIoIndex,
+    (UINT64)ChunkKiB
+    );
+
+  ReadBytes = 0;
+  Lba       = 0;
+  Requests  = 0;
+  Start     = GetPerformanceCounter ();
+
+  while (ReadBytes < TotalBytes) {
+    Status = BlockIo->ReadBlocks (
+                        BlockIo,
+                        Media->MediaId,
+                        Lba,
+                        ChunkSize,
+                        AlignedBuffer
+                        );
+    if (EFI_ERROR (Status)) {
+      Print (L"ReadBlocks failed at LBA 0x%lx: %r\n", Lba, Status);
+      break;
+    }
+
+    ReadBytes += ChunkSize;
+    Lba       += ChunkBlocks;
+    Requests++;
+  }
+
+  ElapsedNs = GetTimeInNanoSecond (GetPerformanceCounter () - Start);
+
+  FreePool (Buffer);
+
+  //
+  // Decimal MB/s, as reported by most disk benchmarks.
+  //
+  Print (
+    L"Read %lu MiB in %lu ms: %lu MB/s, %lu IOPS\n",
+    RShiftU64 (ReadBytes, 20),
+    DivU64x32 (ElapsedNs, 1000000),
+    BenchRate (ReadBytes, 1000, ElapsedNs),
+    BenchRate (Requests, 1000000000, ElapsedNs)
+    );
+
+  return (ReadBytes == TotalBytes) ? EFI_SUCCESS : EFI_DEVICE_ERROR;
+}
@@ -0,0 +1,216 @@
+/** @file
+ *
+ *  Graphics Output Protocol Blt throughput benchmark.
+ *
+ *  Runs Iterations (default 100) full-screen fills, buffer-to-video copies,
+ *  video-to-buffer copies and one text line console scrolls in the current
+ *  mode, or in every available mode if "all" is given, and reports the
+ *  achieved rates. The original mode is restored at the end.
+ *
+ *  Copyright (c) 2026, Rockchip Limited. All rights reserved.
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#include <Library/BaseLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/TimerLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/UefiLib.h>
+#include <Protocol/GraphicsOutput.h>
+
+#include "PerfBench.h"
+
+#define BLT_BENCH_DEFAULT_ITERATIONS  100
+#define BLT_BENCH_SCROLL_LINES        19    // EFI_GLYPH_HEIGHT
+
+typedef enum {
+  BltBenchFill,
+  BltBenchBufferToVideo,
+  BltBenchVideoToBuffer,
+  BltBenchScroll,
+  BltBenchMax
+} BLT_BENCH_TEST;
+
+STATIC CONST CHAR16  *mBltBenchTestNames[BltBenchMax] = {
+  L"Fill",
+  L"BufferToVideo",
+  L"VideoToBuffer",
+  L"Scroll"
+};
+
+STATIC
+VOID
+BltBenchReport (
+  IN BLT_BENCH_TEST  Test,
+  IN UINTN           Iterations,
+  IN UINT64          Bytes,
+  IN UINT64          ElapsedNs
+  )
+{
+  Print (
+    L"  %-14s %6lu ops/s %6lu MB/s\n",
+    mBltBenchTestNames[Test],
+    BenchRate (Iterations, 1000000000, ElapsedNs),
+    BenchRate (Bytes, 1000, ElapsedNs)
+    );
+}
+
+STATIC
+EFI_STATUS
+BltBenchRunMode (
+  IN EFI_GRAPHICS_OUTPUT_PROTOCOL  *Gop,
+  IN UINTN                         Iterations
+  )
+{
+  EFI_STATUS                     Status;
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL  *Buffer;
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL  Color;
+  UINTN                          Width;
+  UINTN                          Height;
+  UINTN                          Pixels;
+  UINTN                          Index;
+  BLT_BENCH_TEST                 Test;
+  UINT64                         Bytes;
+  UINT64                         Start;
+
+  Width  = Gop->Mode->Info->HorizontalResolution;
+  Height = Gop->Mode->Info->VerticalResolution;
+  Pixels = Width * Height;
+
+  if (Height <= BLT_BENCH_SCROLL_LINES) {
+    return EFI_UNSUPPORTED;
+  }
+
+  Buffer = AllocatePool (Pixels * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL));
+  if (Buffer == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  for (Index = 0; Index < Pixels; Index++) {
+    Buffer[Index].Blue     = (UINT8)(Index % Width);
+    Buffer[Index].Green    = (UINT8)(Index / Width);
+    Buffer[Index].Red      = (UINT8)Index;
+    Buffer[Index].Reserved = 0;
+  }
+
+  Print (L"Mode %u: %lux%lu\n", Gop->Mode->Mode, (UINT64)Width, (UINT64)Height);
+
+  for (Test = 0; Test < BltBenchMax; Test++) {
+    Status = EFI_SUCCESS;
+    Bytes  = 0;
+    Start  = GetPerformanceCounter ();
+
+    for (Index = 0; Index < Iterations && !EFI_ERROR (Status); Index++) {
+      switch (Test) {
+        case BltBenchFill:
+          Color.Blue     = (UINT8)Index;
+          Color.Green    = (UINT8)Index;
+          Color.Red      = (UINT8)Index;
+          Color.Reserved = 0;
+
+          Status = Gop->Blt (Gop, &Color, EfiBltVideoFill, 0, 0, 0, 0, Width, Height, 0);
+          Bytes += Pixels * sizeof (Color);
+          break;
+
+        case BltBenchBufferToVideo:
+          Status = Gop->Blt (Gop, Buffer, EfiBltBufferToVideo, 0, 0, 0, 0, Width, Height, 0);
+          Bytes += Pixels * sizeof (*Buffer);
+          break;
+
+        case BltBenchVideoToBuffer:
+          Status = Gop->Blt (Gop, Buffer, EfiBltVideoToBltBuffer, 0, 0, 0, 0, Width, Height, 0);
+          Bytes += Pixels * sizeof (*Buffer);
+          break;
+
+        case BltBenchScroll:
+          Status = Gop->Blt (
+                          Gop,
+                          NULL,
+                          EfiBltVideoToVideo,
+                          0,
+                          BLT_BENCH_SCROLL_LINES,
+                          0,
+                          0,
+                          Width,
+                          Height - BLT_BENCH_SCROLL_LINES,
+                          0
+                          );
+          Bytes += (Height - BLT_BENCH_SCROLL_LINES) * Width * sizeof (*Buffer);
+          break;
+
+        default:
+          break;
+      }
+    }
+
+    if (EFI_ERROR (Status)) {
+      Print (L"  %-14s failed: %r\n", mBltBenchTestNames[Test], Status);
+      continue;
+    }
+
+    BltBenchReport (Test, Iterations, Bytes, GetTimeInNanoSecond (GetPerformanceCounter () - Start));
+  }
+
+  FreePool (Buffer);
+
+  return EFI_SUCCESS;
+}
+
+EFI_STATUS
+BenchGopBlt (
+  IN UINTN   Argc,
+  IN CHAR16  **Argv
+  )
+{
+  EFI_STATUS                    Status;
+  EFI_GRAPHICS_OUTPUT_PROTOCOL  *Gop;
+  UINTN                         Iterations;
+  BOOLEAN                       AllModes;
+  UINT32                        OriginalMode;
+  UINT32                        Mode;
+
+  Iterations = BLT_BENCH_DEFAULT_ITERATIONS;
+  AllModes   = FALSE;
+
+  if (Argc > 1) {
+    Iterations = StrDecimalToUintn (Argv[1]);
+  }
+
+  if (Argc > 2) {
+    AllModes = (StrCmp (Argv[2], L"all") == 0);
+  }
+
+  if (Iterations == 0) {
+    Print (L"Iterations must not be 0\n");
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Status = gBS->LocateProtocol (&gEfiGraphicsOutputProtocolGuid, NULL, (VOID **)&Gop);
+  if (EFI_ERROR (Status)) {
+    Print (L"Graphics Output Protocol not found\n");
+    return Status;
+  }
+
+  if (!AllModes) {
+    return BltBenchRunMode (Gop, Iterations);
+  }
+
+  OriginalMode = Gop->Mode->Mode;
+
+  for (Mode = 0; Mode < Gop->Mode->MaxMode; Mode++) {
+    Status = Gop->SetMode (Gop, Mode);
+    if (EFI_ERROR (Status)) {
+      continue;
+    }
+
+    BltBenchRunMode (Gop, Iterations);
+  }
+
+  Status = Gop->SetMode (Gop, OriginalMode);
+
+  Print (L"Restored mode %u: %r\n", OriginalMode, Status);
+
+  return EFI_SUCCESS;
+}
@@ -0,0 +1,94 @@
+/** @file
+ *
+ *  Firmware throughput benchmarks.
+ *
+ *  Usage: PerfBench <Benchmark> [Arguments]
+ *
+ *    net   [FrameCount] [SnpIndex]             SNP transmit throughput
+ *    blkio [SizeMiB] [BlockIoIndex] [ChunkKiB] Block I/O read throughput
+ *    blt   [Iterations] [all]                  GOP Blt throughput
+ *
+ *  Copyright (c) 2026, Rockchip Limited. All rights reserved.
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#include <Library/BaseLib.h>
+#include <Library/UefiApplicationEntryPoint.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/UefiLib.h>
+#include <Protocol/ShellParameters.h>
+
+#include "PerfBench.h"
+
+typedef struct {
+  CONST CHAR16      *Name;
+  CONST CHAR16      *Usage;
+  PERF_BENCH_RUN    Run;
+} PERF_BENCH;
+
+STATIC CONST PERF_BENCH  mBenchmarks[] = {
+  { L"net",   L"[FrameCount] [SnpIndex]",             BenchSnpTx       },
+  { L"blkio", L"[SizeMiB] [BlockIoIndex] [ChunkKiB]", BenchBlockIoRead },
+  { L"blt",   L"[Iterations] [all]",                  BenchGopBlt      },
+};
+
+UINT64
+BenchRate (
+  IN UINT64  Count,
+  IN UINT32  Scale,
+  IN UINT64  ElapsedNs
+  )
+{
+  if (ElapsedNs == 0) {
+    ElapsedNs = 1;
+  }
+
+  return DivU64x64Remainder (MultU64x32 (Count, Scale), ElapsedNs, NULL);
+}
+
+STATIC
+VOID
+BenchPrintUsage (
+  VOID
+  )
+{
+  UINTN  Index;
+
+  Print (L"Usage:\n");
+  for (Index = 0; Index < ARRAY_SIZE (mBenchmarks); Index++) {
+    Print (L"  PerfBench %-5s %s\n", mBenchmarks[Index].Name, mBenchmarks[Index].Usage);
+  }
+}
+
+EFI_STATUS
+EFIAPI
+UefiMain (
+  IN EFI_HANDLE        ImageHandle,
+  IN EFI_SYSTEM_TABLE  *SystemTable
+  )
+{
+  EFI_STATUS                     Status;
+  EFI_SHELL_PARAMETERS_PROTOCOL  *ShellParameters;
+  UINTN                          Index;
+
+  Status = gBS->HandleProtocol (
+                  ImageHandle,
+                  &gEfiShellParametersProtocolGuid,
+                  (VOID **)&ShellParameters
+                  );
+  if (EFI_ERROR (Status) || (ShellParameters->Argc < 2)) {
+    BenchPrintUsage ();
+    return EFI_INVALID_PARAMETER;
+  }
+
+  for (Index = 0; Index < ARRAY_SIZE (mBenchmarks); Index++) {
+    if (StrCmp (ShellParameters->Argv[1], mBenchmarks[Index].Name) == 0) {
+      return mBenchmarks[Index].Run (ShellParameters->Argc - 1, &ShellParameters->Argv[1]);
+    }
+  }
+
+  BenchPrintUsage ();
+  return EFI_INVALID_PARAMETER;
+}
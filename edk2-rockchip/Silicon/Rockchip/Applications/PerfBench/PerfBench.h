@@ -0,0 +1,61 @@
+/** @file
+ *
+ *  Firmware throughput benchmarks.
+ *
+ *  Copyright (c) 2026, Rockchip Limited. All rights reserved.
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#ifndef __PERF_BENCH_H__
+#define __PERF_BENCH_H__
+
+#include <Uefi.h>
+
+/**
+  Runs one benchmark.
+
+  @param[in] Argc   Number of arguments, including the benchmark name.
+  @param[in] Argv   The arguments, Argv[0] is the benchmark name.
+
+  @retval EFI_SUCCESS   The benchmark completed.
+  @retval Others        The benchmark could not run or failed.
+**/
+typedef
+EFI_STATUS
+(*PERF_BENCH_RUN)(
+  IN UINTN   Argc,
+  IN CHAR16  **Argv
+  );
+
+/**
+  Returns Count scaled by Scale per nanosecond, e.g. per second for a
+  Scale of 1000000000.
+**/
+UINT64
+BenchRate (
+  IN UINT64  Count,
+  IN UINT32  Scale,
+  IN UINT64  ElapsedNs
+  );
+
+EFI_STATUS
+BenchSnpTx (
+  IN UINTN   Argc,
+  IN CHAR16  **Argv
+  );
+
+EFI_STATUS
+BenchBlockIoRead (
+  IN UINTN   Argc,
+  IN CHAR16  **Argv
+  );
+
+EFI_STATUS
+BenchGopBlt (
+  IN UINTN   Argc,
+  IN CHAR16  **Argv
+  );
+
+#endif // __PERF_BENCH_H__
@@ -436,6 +436,49 @@ EdidDetailedTimingToDisplayModeMatch (
   return EFI_SUCCESS;
 }
 
+STATIC
+BOOLEAN
+EdidGetDetailedTimings (
+  IN  UINT8                 *Edid,
+  IN  UINT8                 BlockIndex,
+  OUT EDID_DETAILED_TIMING  **DetailedTimings,
+  OUT UINT8                 *DetailedTimingsCount
+  )
+{
+  UINT8  DtdOffset;
+  UINT8  DtdEnd;
+
+  if (BlockIndex == 0) {
+    *DetailedTimings      = ((EDID_BASE *)Edid)->DetailedTimings;
+    *DetailedTimingsCount = EDID_NUMBER_OF_DETAILED_TIMINGS;
+    return TRUE;
+  }
+
+  switch (Edid[0x00]) {
+    case EDID_EXTENSION_CEA_861:
+      DtdOffset = Edid[0x02];
+      DtdEnd    = EDID_BLOCK_SIZE - 1;
+
+      if ((DtdOffset < CEA_DATA_OFFSET) || (DtdOffset >= DtdEnd)) {
+        return FALSE;
+      }
+
+      *DetailedTimings      = (EDID_DETAILED_TIMING *)(Edid + DtdOffset);
+      *DetailedTimingsCount = (DtdEnd - DtdOffset) / sizeof (EDID_DETAILED_TIMING);
+      return TRUE;
+    case EDID_EXTENSION_VTB:
+      if (Edid[0x01] != 1) {
+        return FALSE;
+      }
+
+      *DetailedTimings      = (EDID_DETAILED_TIMING *)(Edid + 0x05);
+      *DetailedTimingsCount = MIN (Edid[0x02], 6);
+      return TRUE;
+    default:
+      return FALSE;
+  }
+}
+
 STATIC
 EFI_STATUS
 EFIAPI
@@ -457,33 +500,8 @@ EdidGetPreferredModeDetailed (
   for (BlockIndex = 0; BlockIndex < BlockCount; BlockIndex++) {
     Edid = EDID_BLOCK (ConnectorState->Edid, BlockIndex);
 
-    if (BlockIndex == 0) {
-      DetailedTimings      = ((EDID_BASE *)Edid)->DetailedTimings;
-      DetailedTimingsCount = EDID_NUMBER_OF_DETAILED_TIMINGS;
-    } else {
-      switch (Edid[0x00]) {
-        case EDID_EXTENSION_CEA_861:
-          UINT8  DtdOffset = Edid[0x02];
-          UINT8  DtdEnd    = EDID_BLOCK_SIZE - 1;
-
-          if ((DtdOffset < CEA_DATA_OFFSET) || (DtdOffset >= DtdEnd)) {
-            continue;
-          }
-
-          DetailedTimings      = (EDID_DETAILED_TIMING *)(Edid + DtdOffset);
-          DetailedTimingsCount = (DtdEnd - DtdOffset) / sizeof (EDID_DETAILED_TIMING);
-          break;
-        case EDID_EXTENSION_VTB:
-          if (Edid[0x01] != 1) {
-            continue;
-          }
-
-          DetailedTimings      = (EDID_DETAILED_TIMING *)(Edid + 0x05);
-          DetailedTimingsCount = MIN (Edid[0x02], 6);
-          break;
-        default:
-          continue;
-      }
+    if (!EdidGetDetailedTimings (Edid, BlockIndex, &DetailedTimings, &DetailedTimingsCount)) {
+      continue;
     }
 
     for (Index = 0; Index < DetailedTimingsCount; Index++) {
@@ -571,42 +589,58 @@ CeaVideoDataBlockGetFirstSupportedMode (
 }
 
 STATIC
-CONST DISPLAY_MODE *
-CeaHdmiVsdbDataBlockGetFirstSupportedMode (
-  IN CONNECTOR_STATE  *ConnectorState,
-  IN UINT8            *DataBlock
+BOOLEAN
+CeaHdmiVsdbDataBlockGetVics (
+  IN  UINT8  *DataBlock,
+  OUT UINT8  *VicsOffset,
+  OUT UINT8  *VicsCount
   )
 {
-  UINT8               VsdbLength;
-  UINT8               VicsOffset;
-  UINT8               VicsCount;
-  UINT8               Index;
-  UINT8               Vic;
-  CONST DISPLAY_MODE  *PredefinedMode;
+  UINT8  VsdbLength;
 
   VsdbLength = CEA_DATA_BLOCK_PAYLOAD_LENGTH (DataBlock);
 
   if ((VsdbLength < 8) || ((DataBlock[8] & BIT5) == 0)) {
-    return NULL;
+    return FALSE;
   }
 
-  VicsOffset = 15;
+  *VicsOffset = 15;
 
   if ((DataBlock[8] & BIT7) == 0) {
-    VicsOffset -= 2;
+    *VicsOffset -= 2;
   }
 
   if ((DataBlock[8] & BIT6) == 0) {
-    VicsOffset -= 2;
+    *VicsOffset -= 2;
   }
 
-  if (VsdbLength < VicsOffset) {
-    return NULL;
+  if (VsdbLength < *VicsOffset) {
+    return FALSE;
+  }
+
+  *VicsCount = DataBlock[*VicsOffset - 1] >> 5;
+
+  if (*VicsOffset + *VicsCount > VsdbLength + 1) {
+    return FALSE;
   }
 
-  VicsCount = DataBlock[VicsOffset - 1] >> 5;
+  return TRUE;
+}
+
+STATIC
+CONST DISPLAY_MODE *
+CeaHdmiVsdbDataBlockGetFirstSupportedMode (
+  IN CONNECTOR_STATE  *ConnectorState,
+  IN UINT8            *DataBlock
+  )
+{
+  UINT8               VicsOffset;
+  UINT8               VicsCount;
+  UINT8               Index;
+  UINT8               Vic;
+  CONST DISPLAY_MODE  *PredefinedMode;
 
-  if (VicsOffset + VicsCount > VsdbLength + 1) {
+  if (!CeaHdmiVsdbDataBlockGetVics (DataBlock, &VicsOffset, &VicsCount)) {
     return NULL;
   }
 
@@ -964,6 +998,204 @@ EdidGetPreferredMode (
   return EFI_NOT_FOUND;
 }
 
+STATIC
+BOOLEAN
+EdidIsModeAdvertisedDetailed (
+  IN CONNECTOR_STATE     *ConnectorState,
+  IN CONST DISPLAY_MODE  *PredefinedMode
+  )
+{
+  EFI_STATUS            Status;
+  UINT8                 *Edid;
+  UINT8                 BlockIndex;
+  UINT8                 BlockCount;
+  UINT8                 Index;
+  EDID_DETAILED_TIMING  *DetailedTimings;
+  UINT8                 DetailedTimingsCount;
+  DISPLAY_MODE          DisplayMode;
+
+  BlockCount = EDID_GET_BLOCK_COUNT (ConnectorState->Edid);
+
+  for (BlockIndex = 0; BlockIndex < BlockCount; BlockIndex++) {
+    Edid = EDID_BLOCK (ConnectorState->Edid, BlockIndex);
+
+    if (!EdidGetDetailedTimings (Edid, BlockIndex, &DetailedTimings, &DetailedTimingsCount)) {
+      continue;
+    }
+
+    for (Index = 0; Index < DetailedTimingsCount; Index++) {
+      Status = EdidDetailedTimingToDisplayMode (&DetailedTimings[Index], &DisplayMode);
+      if (EFI_ERROR (Status)) {
+        continue;
+      }
+
+      if ((DisplayMode.HActive == PredefinedMode->HActive) &&
+          (DisplayMode.VActive == PredefinedMode->VActive) &&
+          (DisplayModeVRefresh (&DisplayMode) == DisplayModeVRefresh (PredefinedMode)))
+      {
+        return TRUE;
+      }
+    }
+  }
+
+  return FALSE;
+}
+
+STATIC
+BOOLEAN
+EdidIsModeAdvertisedCea (
+  IN CONNECTOR_STATE     *ConnectorState,
+  IN CONST DISPLAY_MODE  *PredefinedMode
+  )
+{
+  UINT8  *Edid;
+  UINT8  BlockIndex;
+  UINT8  BlockCount;
+  UINT8  DataBlocksEnd;
+  UINT8  DataBlockOffset;
+  UINT8  DataBlockLength;
+  UINT8  *DataBlock;
+  UINT8  Index;
+  UINT8  VicsOffset;
+  UINT8  VicsCount;
+
+  if (PredefinedMode->Vic == 0) {
+    return FALSE;
+  }
+
+  BlockCount = EDID_GET_BLOCK_COUNT (ConnectorState->Edid);
+
+  for (BlockIndex = 1; BlockIndex < BlockCount; BlockIndex++) {
+    Edid = EDID_BLOCK (ConnectorState->Edid, BlockIndex);
+
+    if ((Edid[0x00] != EDID_EXTENSION_CEA_861) || (Edid[0x01] < 3)) {
+      continue;
+    }
+
+    DataBlocksEnd = Edid[0x02];
+    if (DataBlocksEnd > EDID_BLOCK_SIZE - 1) {
+      continue;
+    }
+
+    for (DataBlockOffset = CEA_DATA_OFFSET; DataBlockOffset < DataBlocksEnd;) {
+      DataBlock       = Edid + DataBlockOffset;
+      DataBlockLength = 1 + CEA_DATA_BLOCK_PAYLOAD_LENGTH (DataBlock);
+
+      if (DataBlockOffset + DataBlockLength > DataBlocksEnd) {
+        break;
+      }
+
+      if (CeaIsVideoDataBlock (DataBlock)) {
+        for (Index = 0; Index < CEA_DATA_BLOCK_PAYLOAD_LENGTH (DataBlock); Index++) {
+          if (CeaSvdToVic (CEA_DATA_BLOCK_PAYLOAD (DataBlock)[Index]) == PredefinedMode->Vic) {
+            return TRUE;
+          }
+        }
+      } else if (CeaIsHdmiVsdbDataBlock (DataBlock) &&
+                 CeaHdmiVsdbDataBlockGetVics (DataBlock, &VicsOffset, &VicsCount))
+      {
+        for (Index = 0; Index < VicsCount; Index++) {
+          if (ConvertHdmiToCeaVic (DataBlock[VicsOffset + Index]) == PredefinedMode->Vic) {
+            return TRUE;
+          }
+        }
+      }
+
+      DataBlockOffset += DataBlockLength;
+    }
+  }
+
+  return FALSE;
+}
+
+STATIC
+BOOLEAN
+EdidIsModeAdvertisedStandard (
+  IN CONNECTOR_STATE     *ConnectorState,
+  IN CONST DISPLAY_MODE  *PredefinedMode
+  )
+{
+  EFI_STATUS  Status;
+  EDID_BASE   *Edid;
+  UINT8       Index;
+  UINT16      HorizontalResolution;
+  UINT16      VerticalResolution;
+  UINT8       RefreshRate;
+
+  Edid = (EDID_BASE *)EDID_BLOCK (ConnectorState->Edid, 0);
+
+  for (Index = 0; Index < EDID_NUMBER_OF_STANDARD_TIMINGS; Index++) {
+    Status = EdidParseStandardTiming (
+               &Edid->StandardTimings[Index],
+               &HorizontalResolution,
+               &VerticalResolution,
+               &RefreshRate
+               );
+    if (EFI_ERROR (Status)) {
+      continue;
+    }
+
+    if ((HorizontalResolution == PredefinedMode->HActive) &&
+        (VerticalResolution == PredefinedMode->VActive) &&
+        (RefreshRate == DisplayModeVRefresh (PredefinedMode)))
+    {
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+STATIC
+BOOLEAN
+EdidIsModeAdvertisedEstablished (
+  IN CONNECTOR_STATE     *ConnectorState,
+  IN CONST DISPLAY_MODE  *PredefinedMode
+  )
+{
+  EDID_BASE  *Edid;
+
+  Edid = (EDID_BASE *)EDID_BLOCK (ConnectorState->Edid, 0);
+
+  return EdidIsEstablishedModeSupported (
+           Edid->EstablishedTimings,
+           PredefinedMode->HActive,
+           PredefinedMode->VActive,
+           DisplayModeVRefresh (PredefinedMode)
+           );
+}
+
+typedef
+BOOLEAN
+(*EDID_IS_MODE_ADVERTISED)(
+  IN CONNECTOR_STATE     *ConnectorState,
+  IN CONST DISPLAY_MODE  *PredefinedMode
+  );
+
+STATIC EDID_IS_MODE_ADVERTISED  mEdidIsModeAdvertisedOps[] = {
+  EdidIsModeAdvertisedDetailed,
+  EdidIsModeAdvertisedCea,
+  EdidIsModeAdvertisedStandard,
+  EdidIsModeAdvertisedEstablished,
+};
+
+BOOLEAN
+EdidIsPredefinedModeAdvertised (
+  IN CONNECTOR_STATE     *ConnectorState,
+  IN CONST DISPLAY_MODE  *PredefinedMode
+  )
+{
+  UINT32  Index;
+
+  for (Index = 0; Index < ARRAY_SIZE (mEdidIsModeAdvertisedOps); Index++) {
+    if (mEdidIsModeAdvertisedOps[Index](ConnectorState, PredefinedMode)) {
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
 EFI_STATUS
 EdidGetDisplaySinkInfo (
   IN CONNECTOR_STATE  *ConnectorState
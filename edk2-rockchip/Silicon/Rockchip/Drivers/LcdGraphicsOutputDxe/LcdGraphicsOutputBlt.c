@@ -7,9 +7,221 @@
 **/
 
 #include <Library/BaseMemoryLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UefiBootServicesTableLib.h>
 
 #include "LcdGraphicsOutputDxe.h"
 
+/**
+  Allocate a shadow buffer large enough for the given framebuffer size,
+  reusing the current one if it is already big enough.
+
+  Blt reads are served from the shadow buffer, so writes made directly to
+  FrameBufferBase are not seen by later VideoToBltBuffer or VideoToVideo
+  operations until the next SetMode.
+
+  @param[in]  Instance   The LCD instance.
+  @param[in]  Size       The framebuffer size in bytes.
+
+  @retval EFI_SUCCESS            The shadow buffer is ready for use.
+  @retval EFI_OUT_OF_RESOURCES   The allocation failed. Blt operations
+                                 will access the scanout buffer directly.
+**/
+EFI_STATUS
+LcdGraphicsAllocateShadowBuffer (
+  IN LCD_INSTANCE  *Instance,
+  IN UINTN         Size
+  )
+{
+  UINTN  Pages;
+
+  Pages = EFI_SIZE_TO_PAGES (Size);
+  if (Pages <= Instance->ShadowBufferPages) {
+    return EFI_SUCCESS;
+  }
+
+  if (Instance->ShadowBuffer != NULL) {
+    FreePages (Instance->ShadowBuffer, Instance->ShadowBufferPages);
+    Instance->ShadowBuffer      = NULL;
+    Instance->ShadowBufferPages = 0;
+  }
+
+  Instance->ShadowBuffer = AllocatePages (Pages);
+  if (Instance->ShadowBuffer == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Instance->ShadowBufferPages = Pages;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Copy a rectangle from the shadow buffer to the scanout buffer.
+
+  The coordinates are in framebuffer (scanout) pixels. Full-width rectangles
+  are contiguous and get copied in one go.
+**/
+STATIC
+VOID
+LcdGraphicsFlush (
+  IN EFI_GRAPHICS_OUTPUT_PROTOCOL  *This,
+  IN LCD_INSTANCE                  *Instance,
+  IN UINTN                         X,
+  IN UINTN                         Y,
+  IN UINTN                         Width,
+  IN UINTN                         Height,
+  IN UINTN                         Stride
+  )
+{
+  UINT32  *FrameBuffer;
+  UINTN   Offset;
+  UINTN   Row;
+
+  if (Instance->ShadowBuffer == NULL) {
+    return;
+  }
+
+  FrameBuffer = (UINT32 *)This->Mode->FrameBufferBase;
+  Offset      = Y * Stride + X;
+
+  if (Width == Stride) {
+    CopyMem (
+      FrameBuffer + Offset,
+      Instance->ShadowBuffer + Offset,
+      Width * Height * RK_BYTES_PER_PIXEL
+      );
+    return;
+  }
+
+  for (Row = 0; Row < Height; Row++) {
+    CopyMem (
+      FrameBuffer + Offset,
+      Instance->ShadowBuffer + Offset,
+      Width * RK_BYTES_PER_PIXEL
+      );
+    Offset += Stride;
+  }
+}
+
+/**
+  Add a rectangle to the area that the next flush copies to the scanout
+  buffer.
+
+  The coordinates are in framebuffer (scanout) pixels. Rectangles are
+  merged into their bounding box, so two small updates far apart flush
+  everything in between.
+**/
+STATIC
+VOID
+LcdGraphicsMarkDirty (
+  IN LCD_INSTANCE  *Instance,
+  IN UINTN         X,
+  IN UINTN         Y,
+  IN UINTN         Width,
+  IN UINTN         Height
+  )
+{
+  EFI_TPL  OldTpl;
+
+  if (Instance->ShadowBuffer == NULL) {
+    return;
+  }
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+
+  if (Instance->DirtyRight == 0) {
+    Instance->DirtyLeft   = X;
+    Instance->DirtyTop    = Y;
+    Instance->DirtyRight  = X + Width;
+    Instance->DirtyBottom = Y + Height;
+  } else {
+    Instance->DirtyLeft   = MIN (Instance->DirtyLeft, X);
+    Instance->DirtyTop    = MIN (Instance->DirtyTop, Y);
+    Instance->DirtyRight  = MAX (Instance->DirtyRight, X + Width);
+    Instance->DirtyBottom = MAX (Instance->DirtyBottom, Y + Height);
+  }
+
+  gBS->RestoreTPL (OldTpl);
+}
+
+/**
+  Drop the pending dirty area without copying it, e.g. because the scanout
+  buffer is about to be replaced.
+
+  @param[in]  Instance   The LCD instance.
+**/
+VOID
+LcdGraphicsDiscardDirty (
+  IN LCD_INSTANCE  *Instance
+  )
+{
+  EFI_TPL  OldTpl;
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+
+  Instance->DirtyLeft   = 0;
+  Instance->DirtyTop    = 0;
+  Instance->DirtyRight  = 0;
+  Instance->DirtyBottom = 0;
+
+  gBS->RestoreTPL (OldTpl);
+}
+
+/**
+  Copy the pending dirty area from the shadow buffer to the scanout buffer.
+
+  Blt calls that land while the copy is in progress mark their rectangle
+  dirty again and get picked up by the next flush.
+
+  @param[in]  Instance   The LCD instance.
+**/
+VOID
+LcdGraphicsFlushDirty (
+  IN LCD_INSTANCE  *Instance
+  )
+{
+  EFI_GRAPHICS_OUTPUT_PROTOCOL  *This;
+  EFI_TPL                       OldTpl;
+  UINTN                         Left;
+  UINTN                         Top;
+  UINTN                         Right;
+  UINTN                         Bottom;
+  UINTN                         Stride;
+
+  This = &Instance->Gop;
+
+  if ((Instance->ShadowBuffer == NULL) || (This->Mode->FrameBufferSize == 0)) {
+    return;
+  }
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+
+  Left   = Instance->DirtyLeft;
+  Top    = Instance->DirtyTop;
+  Right  = Instance->DirtyRight;
+  Bottom = Instance->DirtyBottom;
+
+  Instance->DirtyLeft   = 0;
+  Instance->DirtyTop    = 0;
+  Instance->DirtyRight  = 0;
+  Instance->DirtyBottom = 0;
+
+  gBS->RestoreTPL (OldTpl);
+
+  if (Right == 0) {
+    return;
+  }
+
+  //
+  // The rotated framebuffer is VerticalResolution pixels wide.
+  //
+  Stride = (This->Blt == LcdGraphicsBlt90) ? This->Mode->Info->VerticalResolution
+                                           : This->Mode->Info->HorizontalResolution;
+
+  LcdGraphicsFlush (This, Instance, Left, Top, Right - Left, Bottom - Top, Stride);
+}
+
 STATIC
 EFI_STATUS
 LcdGraphicsBltCheckParameters (
@@ -88,15 +300,18 @@ LcdGraphicsBlt (
   IN UINTN                              Delta       OPTIONAL
   )
 {
-  EFI_STATUS  Status;
-  UINT32      *FrameBuffer;
-  UINT32      HorizontalResolution;
-  UINTN       WidthInBytes;
-  UINT32      *SourceBuffer;
-  UINT32      *DestinationBuffer;
-  UINTN       Y;
-
-  FrameBuffer          = (UINT32 *)This->Mode->FrameBufferBase;
+  EFI_STATUS    Status;
+  LCD_INSTANCE  *Instance;
+  UINT32        *FrameBuffer;
+  UINT32        HorizontalResolution;
+  UINTN         WidthInBytes;
+  UINT32        *SourceBuffer;
+  UINT32        *DestinationBuffer;
+  UINTN         Y;
+
+  Instance             = LCD_INSTANCE_FROM_GOP_THIS (This);
+  FrameBuffer          = (Instance->ShadowBuffer != NULL) ? Instance->ShadowBuffer
+                                                          : (UINT32 *)This->Mode->FrameBufferBase;
   HorizontalResolution = This->Mode->Info->HorizontalResolution;
   WidthInBytes         = Width * RK_BYTES_PER_PIXEL;
 
@@ -120,12 +335,24 @@ LcdGraphicsBlt (
     case EfiBltVideoFill:
       SourceBuffer = (UINT32 *)BltBuffer;
 
+      //
+      // Full-width rectangles are contiguous and get filled in one go.
+      //
+      if (Width == HorizontalResolution) {
+        LcdBltFillRow (
+          FrameBuffer + DestinationY * HorizontalResolution,
+          Width * Height,
+          *SourceBuffer
+          );
+        break;
+      }
+
       for (Y = 0; Y < Height; Y++) {
         DestinationBuffer = FrameBuffer +
                             (DestinationY + Y) * HorizontalResolution +
                             DestinationX;
 
-        SetMem32 (DestinationBuffer, WidthInBytes, *SourceBuffer);
+        LcdBltFillRow (DestinationBuffer, Width, *SourceBuffer);
       }
 
       break;
@@ -201,9 +428,211 @@ LcdGraphicsBlt (
       return EFI_INVALID_PARAMETER;
   }
 
+  if (BltOperation != EfiBltVideoToBltBuffer) {
+    LcdGraphicsMarkDirty (
+      Instance,
+      DestinationX,
+      DestinationY,
+      Width,
+      Height
+      );
+  }
+
   return EFI_SUCCESS;
 }
 
+/**
+  Copy a rectangle between a Blt buffer and the 90 degree rotated
+  framebuffer, one pixel at a time.
+
+  This is the reference implementation, also used for the edges that
+  don't fill a whole tile.
+**/
+STATIC
+VOID
+LcdBlt90CopyPixels (
+  IN     UINT32                         *FrameBuffer,
+  IN     UINTN                          Stride,
+  IN OUT EFI_GRAPHICS_OUTPUT_BLT_PIXEL  *BltBuffer,
+  IN     UINTN                          Delta,
+  IN     BOOLEAN                        ToVideo,
+  IN     UINTN                          BufferX,
+  IN     UINTN                          BufferY,
+  IN     UINTN                          VideoX,
+  IN     UINTN                          VideoY,
+  IN     UINTN                          Width,
+  IN     UINTN                          Height
+  )
+{
+  UINT32  *VideoPixel;
+  UINT32  *BufferPixel;
+  UINTN   Y;
+  UINTN   X;
+
+  for (Y = 0; Y < Height; Y++) {
+    for (X = 0; X < Width; X++) {
+      VideoPixel = FrameBuffer +
+                   (Stride - 1 - (VideoY + Y)) +
+                   (VideoX + X) * Stride;
+
+      BufferPixel = (UINT32 *)((UINTN)BltBuffer +
+                               (BufferY + Y) * Delta +
+                               (BufferX + X) * RK_BYTES_PER_PIXEL);
+
+      if (ToVideo) {
+        *VideoPixel = *BufferPixel;
+      } else {
+        *BufferPixel = *VideoPixel;
+      }
+    }
+  }
+}
+
+/**
+  Copy a Blt buffer rectangle to the 90 degree rotated framebuffer.
+
+  Whole 4x4 tiles are transposed with LcdBltTranspose4x4(). The buffer rows
+  are read bottom-up so that each framebuffer row comes out in increasing
+  address order.
+**/
+STATIC
+VOID
+LcdBlt90BufferToVideo (
+  IN UINT32                         *FrameBuffer,
+  IN UINTN                          Stride,
+  IN EFI_GRAPHICS_OUTPUT_BLT_PIXEL  *BltBuffer,
+  IN UINTN                          Delta,
+  IN UINTN                          SourceX,
+  IN UINTN                          SourceY,
+  IN UINTN                          DestinationX,
+  IN UINTN                          DestinationY,
+  IN UINTN                          Width,
+  IN UINTN                          Height
+  )
+{
+  UINTN  TiledWidth;
+  UINTN  TiledHeight;
+  UINTN  X;
+  UINTN  Y;
+
+  TiledWidth  = Width & ~(UINTN)3;
+  TiledHeight = Height & ~(UINTN)3;
+
+  for (X = 0; X < TiledWidth; X += 4) {
+    for (Y = TiledHeight; Y > 0; Y -= 4) {
+      LcdBltTranspose4x4 (
+        FrameBuffer + (DestinationX + X) * Stride + (Stride - (DestinationY + Y)),
+        (INTN)(Stride * RK_BYTES_PER_PIXEL),
+        (UINT32 *)((UINTN)BltBuffer + (SourceY + Y - 1) * Delta + (SourceX + X) * RK_BYTES_PER_PIXEL),
+        -(INTN)Delta
+        );
+    }
+  }
+
+  if (TiledWidth < Width) {
+    LcdBlt90CopyPixels (
+      FrameBuffer,
+      Stride,
+      BltBuffer,
+      Delta,
+      TRUE,
+      SourceX + TiledWidth,
+      SourceY,
+      DestinationX + TiledWidth,
+      DestinationY,
+      Width - TiledWidth,
+      Height
+      );
+  }
+
+  if (TiledHeight < Height) {
+    LcdBlt90CopyPixels (
+      FrameBuffer,
+      Stride,
+      BltBuffer,
+      Delta,
+      TRUE,
+      SourceX,
+      SourceY + TiledHeight,
+      DestinationX,
+      DestinationY + TiledHeight,
+      TiledWidth,
+      Height - TiledHeight
+      );
+  }
+}
+
+/**
+  Copy a rectangle of the 90 degree rotated framebuffer to a Blt buffer,
+  the inverse of LcdBlt90BufferToVideo().
+**/
+STATIC
+VOID
+LcdBlt90VideoToBuffer (
+  IN  UINT32                         *FrameBuffer,
+  IN  UINTN                          Stride,
+  OUT EFI_GRAPHICS_OUTPUT_BLT_PIXEL  *BltBuffer,
+  IN  UINTN                          Delta,
+  IN  UINTN                          SourceX,
+  IN  UINTN                          SourceY,
+  IN  UINTN                          DestinationX,
+  IN  UINTN                          DestinationY,
+  IN  UINTN                          Width,
+  IN  UINTN                          Height
+  )
+{
+  UINTN  TiledWidth;
+  UINTN  TiledHeight;
+  UINTN  X;
+  UINTN  Y;
+
+  TiledWidth  = Width & ~(UINTN)3;
+  TiledHeight = Height & ~(UINTN)3;
+
+  for (X = 0; X < TiledWidth; X += 4) {
+    for (Y = TiledHeight; Y > 0; Y -= 4) {
+      LcdBltTranspose4x4 (
+        (UINT32 *)((UINTN)BltBuffer + (DestinationY + Y - 1) * Delta + (DestinationX + X) * RK_BYTES_PER_PIXEL),
+        -(INTN)Delta,
+        FrameBuffer + (SourceX + X) * Stride + (Stride - (SourceY + Y)),
+        (INTN)(Stride * RK_BYTES_PER_PIXEL)
+        );
+    }
+  }
+
+  if (TiledWidth < Width) {
+    LcdBlt90CopyPixels (
+      FrameBuffer,
+      Stride,
+      BltBuffer,
+      Delta,
+      FALSE,
+      DestinationX + TiledWidth,
+      DestinationY,
+      SourceX + TiledWidth,
+      SourceY,
+      Width - TiledWidth,
+      Height
+      );
+  }
+
+  if (TiledHeight < Height) {
+    LcdBlt90CopyPixels (
+      FrameBuffer,
+      Stride,
+      BltBuffer,
+      Delta,
+      FALSE,
+      DestinationX,
+      DestinationY + TiledHeight,
+      SourceX,
+      SourceY + TiledHeight,
+      TiledWidth,
+      Height - TiledHeight
+      );
+  }
+}
+
 EFI_STATUS
 EFIAPI
 LcdGraphicsBlt90 (
@@ -219,16 +648,19 @@ LcdGraphicsBlt90 (
   IN UINTN                              Delta       OPTIONAL
   )
 {
-  EFI_STATUS  Status;
-  UINT32      *FrameBuffer;
-  UINT32      HorizontalResolution;
-  UINTN       WidthInBytes;
-  UINT32      *SourceBuffer;
-  UINT32      *DestinationBuffer;
-  UINTN       Y;
-  UINTN       X;
-
-  FrameBuffer          = (UINT32 *)This->Mode->FrameBufferBase;
+  EFI_STATUS    Status;
+  LCD_INSTANCE  *Instance;
+  UINT32        *FrameBuffer;
+  UINT32        HorizontalResolution;
+  UINTN         WidthInBytes;
+  UINT32        *SourceBuffer;
+  UINT32        *DestinationBuffer;
+  UINTN         Row;
+  UINTN         X;
+
+  Instance             = LCD_INSTANCE_FROM_GOP_THIS (This);
+  FrameBuffer          = (Instance->ShadowBuffer != NULL) ? Instance->ShadowBuffer
+                                                          : (UINT32 *)This->Mode->FrameBufferBase;
   HorizontalResolution = This->Mode->Info->VerticalResolution;
   WidthInBytes         = Width * RK_BYTES_PER_PIXEL;
 
@@ -248,18 +680,21 @@ LcdGraphicsBlt90 (
     return Status;
   }
 
+  //
+  // GOP pixel (X, Y) lives at framebuffer row X, column (Stride - 1 - Y), so
+  // a GOP rectangle maps to a transposed framebuffer rectangle whose rows are
+  // contiguous: Height pixels starting at column (Stride - Y - Height).
+  //
   switch (BltOperation) {
     case EfiBltVideoFill:
       SourceBuffer = (UINT32 *)BltBuffer;
 
-      for (Y = 0; Y < Height; Y++) {
-        for (X = 0; X < Width; X++) {
-          DestinationBuffer = FrameBuffer +
-                              (HorizontalResolution - 1 - (DestinationY + Y)) +
-                              (DestinationX + X) * HorizontalResolution;
+      for (X = 0; X < Width; X++) {
+        DestinationBuffer = FrameBuffer +
+                            (DestinationX + X) * HorizontalResolution +
+                            (HorizontalResolution - DestinationY - Height);
 
-          *DestinationBuffer = *SourceBuffer;
-        }
+        LcdBltFillRow (DestinationBuffer, Height, *SourceBuffer);
       }
 
       break;
@@ -269,20 +704,18 @@ LcdGraphicsBlt90 (
         Delta = WidthInBytes;
       }
 
-      for (Y = 0; Y < Height; Y++) {
-        for (X = 0; X < Width; X++) {
-          SourceBuffer = FrameBuffer +
-                         (HorizontalResolution - 1 - (SourceY + Y)) +
-                         (SourceX + X) * HorizontalResolution;
-
-          DestinationBuffer = (UINT32 *)((UINTN)BltBuffer +
-                                         (DestinationY + Y) * Delta +
-                                         (DestinationX + X) * RK_BYTES_PER_PIXEL);
-
-          *DestinationBuffer = *SourceBuffer;
-        }
-      }
-
+      LcdBlt90VideoToBuffer (
+        FrameBuffer,
+        HorizontalResolution,
+        BltBuffer,
+        Delta,
+        SourceX,
+        SourceY,
+        DestinationX,
+        DestinationY,
+        Width,
+        Height
+        );
       break;
 
     case EfiBltBufferToVideo:
@@ -290,51 +723,36 @@ LcdGraphicsBlt90 (
         Delta = WidthInBytes;
       }
 
-      for (Y = 0; Y < Height; Y++) {
-        for (X = 0; X < Width; X++) {
-          SourceBuffer = (UINT32 *)((UINTN)BltBuffer +
-                                    (SourceY + Y) * Delta +
-                                    (SourceX + X) * RK_BYTES_PER_PIXEL);
-
-          DestinationBuffer = FrameBuffer +
-                              (HorizontalResolution - 1 - (DestinationY + Y)) +
-                              (DestinationX + X) * HorizontalResolution;
-
-          *DestinationBuffer = *SourceBuffer;
-        }
-      }
-
+      LcdBlt90BufferToVideo (
+        FrameBuffer,
+        HorizontalResolution,
+        BltBuffer,
+        Delta,
+        SourceX,
+        SourceY,
+        DestinationX,
+        DestinationY,
+        Width,
+        Height
+        );
       break;
 
     case EfiBltVideoToVideo:
-      if (SourceY < DestinationY) {
-        for (Y = Height; Y-- > 0;) {
-          for (X = 0; X < Width; X++) {
-            SourceBuffer = FrameBuffer +
-                           (HorizontalResolution - 1 - (SourceY + Y)) +
-                           (SourceX + X) * HorizontalResolution;
+      //
+      // Rows may overlap, CopyMem() handles that within a row.
+      //
+      for (X = 0; X < Width; X++) {
+        Row = (SourceX < DestinationX) ? (Width - 1 - X) : X;
 
-            DestinationBuffer = FrameBuffer +
-                                (HorizontalResolution - 1 - (DestinationY + Y)) +
-                                (DestinationX + X) * HorizontalResolution;
-
-            *DestinationBuffer = *SourceBuffer;
-          }
-        }
-      } else {
-        for (Y = 0; Y < Height; Y++) {
-          for (X = 0; X < Width; X++) {
-            SourceBuffer = FrameBuffer +
-                           (HorizontalResolution - 1 - (SourceY + Y)) +
-                           (SourceX + X) * HorizontalResolution;
+        SourceBuffer = FrameBuffer +
+                       (SourceX + Row) * HorizontalResolution +
+                       (HorizontalResolution - SourceY - Height);
 
-            DestinationBuffer = FrameBuffer +
-                                (HorizontalResolution - 1 - (DestinationY + Y)) +
-                                (DestinationX + X) * HorizontalResolution;
+        DestinationBuffer = FrameBuffer +
+                            (DestinationX + Row) * HorizontalResolution +
+                            (HorizontalResolution - DestinationY - Height);
 
-            *DestinationBuffer = *SourceBuffer;
-          }
-        }
+        CopyMem (DestinationBuffer, SourceBuffer, Height * RK_BYTES_PER_PIXEL);
       }
 
       break;
@@ -343,5 +761,18 @@ LcdGraphicsBlt90 (
       return EFI_INVALID_PARAMETER;
   }
 
+  //
+  // The framebuffer is rotated, so the rectangle is transposed.
+  //
+  if (BltOperation != EfiBltVideoToBltBuffer) {
+    LcdGraphicsMarkDirty (
+      Instance,
+      HorizontalResolution - (DestinationY + Height),
+      DestinationX,
+      Height,
+      Width
+      );
+  }
+
   return EFI_SUCCESS;
 }
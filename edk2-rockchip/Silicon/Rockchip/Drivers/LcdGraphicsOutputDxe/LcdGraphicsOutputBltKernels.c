@@ -0,0 +1,41 @@
+/** @file
+
+  Reference implementations of the Blt kernels. Architectures with an
+  optimized version (see AArch64/) use those instead.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "LcdGraphicsOutputDxe.h"
+
+VOID
+LcdBltFillRowReference (
+  OUT UINT32  *Destination,
+  IN  UINTN   Count,
+  IN  UINT32  Value
+  )
+{
+  while (Count-- > 0) {
+    *Destination++ = Value;
+  }
+}
+
+VOID
+LcdBltTranspose4x4Reference (
+  OUT UINT32        *Destination,
+  IN  INTN          DestinationStride,
+  IN  CONST UINT32  *Source,
+  IN  INTN          SourceStride
+  )
+{
+  UINTN  Row;
+  UINTN  Column;
+
+  for (Row = 0; Row < 4; Row++) {
+    for (Column = 0; Column < 4; Column++) {
+      *(UINT32 *)((UINT8 *)Destination + Row * DestinationStride + Column * RK_BYTES_PER_PIXEL) =
+        *(CONST UINT32 *)((CONST UINT8 *)Source + Column * SourceStride + Row * RK_BYTES_PER_PIXEL);
+    }
+  }
+}
@@ -15,6 +15,7 @@
 #include <Library/UefiBootServicesTableLib.h>
 #include <Library/UefiRuntimeServicesTableLib.h>
 #include <Library/MemoryAllocationLib.h>
+#include <Library/TimerLib.h>
 #include <Library/DrmModes.h>
 #include <Library/MediaBusFormat.h>
 
@@ -22,6 +23,11 @@
 
 #include "LcdGraphicsOutputDxe.h"
 
+//
+// How often Blt changes made to the shadow framebuffer reach the screen.
+//
+#define LCD_SHADOW_FLUSH_PERIOD  EFI_TIMER_PERIOD_MILLISECONDS (16)
+
 STATIC EFI_CPU_ARCH_PROTOCOL  *mCpu;
 
 STATIC LCD_INSTANCE  mLcdTemplate = {
@@ -74,8 +80,26 @@ STATIC LCD_INSTANCE  mLcdTemplate = {
   { 0 },                                       // DisplayStates
   0,                                           // DisplayStatesCount
   NULL,                                        // DisplayModes
+  0,                                           // FrameBufferPages
+  NULL,                                        // ShadowBuffer
+  0,                                           // ShadowBufferPages
+  NULL,                                        // FlushEvent
+  NULL,                                        // ExitBootServicesEvent
+  0,                                           // DirtyLeft
+  0,                                           // DirtyTop
+  0,                                           // DirtyRight
+  0,                                           // DirtyBottom
 };
 
+STATIC
+UINT64
+LcdGetElapsedMs (
+  IN UINT64  StartTime
+  )
+{
+  return DivU64x32 (GetTimeInNanoSecond (GetPerformanceCounter () - StartTime), 1000000);
+}
+
 STATIC
 EFI_STATUS
 PrepareDisplays (
@@ -300,6 +324,7 @@ IdentifyDisplay (
   EFI_STATUS                   Status;
   CONNECTOR_STATE              *ConnectorState;
   ROCKCHIP_CONNECTOR_PROTOCOL  *Connector;
+  UINT64                       StartTime;
 
   ConnectorState = &DisplayState->ConnectorState;
   Connector      = (ROCKCHIP_CONNECTOR_PROTOCOL *)ConnectorState->Connector;
@@ -326,7 +351,12 @@ IdentifyDisplay (
   // Get sink info from EDID.
   //
   if (Connector->GetEdid != NULL) {
+    StartTime = GetPerformanceCounter ();
+
     Status = Connector->GetEdid (Connector, DisplayState);
+
+    DEBUG ((DEBUG_INFO, "%a: EDID read took %lu ms\n", __func__, LcdGetElapsedMs (StartTime)));
+
     if (EFI_ERROR (Status)) {
       DEBUG ((
         DEBUG_ERROR,
@@ -422,18 +452,23 @@ SetupAllDisplays (
       continue;
     }
 
-    if (PrimaryDisplayState != NULL) {
-      //
-      // Clone primary display sink info.
-      // This is a best effort to support multiple outputs on
-      // a single CRTC port. All sinks are assumed to have more
-      // or less the same capabilities.
-      //
+    //
+    // Read the sink's own EDID, so that only modes every output accepts
+    // are offered. Otherwise clone the primary display's, as a best effort
+    // to support multiple outputs on a single CRTC port.
+    //
+    Status = IdentifyDisplay (DisplayState);
+    if (EFI_ERROR (Status) && (PrimaryDisplayState != NULL)) {
       CopyMem (
         &DisplayState->ConnectorState.SinkInfo,
         &PrimaryDisplayState->ConnectorState.SinkInfo,
         sizeof (DisplayState->ConnectorState.SinkInfo)
         );
+      CopyMem (
+        DisplayState->ConnectorState.Edid,
+        PrimaryDisplayState->ConnectorState.Edid,
+        sizeof (DisplayState->ConnectorState.Edid)
+        );
     }
 
     Status = SetupDisplay (DisplayState);
@@ -445,6 +480,138 @@ SetupAllDisplays (
   return EFI_SUCCESS;
 }
 
+/**
+  Check whether every enabled display supports a predefined mode and
+  advertises it in its EDID.
+**/
+STATIC
+BOOLEAN
+IsPredefinedModeAdvertisedByAll (
+  IN LCD_INSTANCE        *Instance,
+  IN CONST DISPLAY_MODE  *PredefinedMode
+  )
+{
+  UINTN          Index;
+  DISPLAY_STATE  *DisplayState;
+
+  for (Index = 0; Index < Instance->DisplayStatesCount; Index++) {
+    DisplayState = Instance->DisplayStates[Index];
+    if ((DisplayState == NULL) || !DisplayState->IsEnable) {
+      continue;
+    }
+
+    if (!IsDisplayModeSupported (&DisplayState->ConnectorState, PredefinedMode) ||
+        !EdidIsPredefinedModeAdvertised (&DisplayState->ConnectorState, PredefinedMode))
+    {
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+STATIC
+UINT32
+AddAdvertisedDisplayModes (
+  IN     LCD_INSTANCE  *Instance,
+  IN OUT DISPLAY_MODE  *DisplayModes,
+  IN     UINT32        ModesCount
+  )
+{
+  INT32               Index;
+  UINT32              Position;
+  CONST DISPLAY_MODE  *PredefinedMode;
+
+  //
+  // Walk the predefined table from the top so that the highest refresh
+  // rate wins when several modes share a resolution.
+  //
+  for (Index = GetPredefinedDisplayModesCount () - 1; Index >= 0; Index--) {
+    PredefinedMode = GetPredefinedDisplayMode (Index);
+
+    //
+    // Never offer anything larger than the preferred mode.
+    //
+    if ((PredefinedMode->HActive > DisplayModes[0].HActive) ||
+        (PredefinedMode->VActive > DisplayModes[0].VActive))
+    {
+      continue;
+    }
+
+    for (Position = 0; Position < ModesCount; Position++) {
+      if ((DisplayModes[Position].HActive == PredefinedMode->HActive) &&
+          (DisplayModes[Position].VActive == PredefinedMode->VActive))
+      {
+        break;
+      }
+    }
+
+    if (Position < ModesCount) {
+      continue;
+    }
+
+    if (!IsPredefinedModeAdvertisedByAll (Instance, PredefinedMode)) {
+      continue;
+    }
+
+    //
+    // Keep the list sorted by descending area, after the preferred mode.
+    //
+    for (Position = ModesCount; Position > 1; Position--) {
+      if (DisplayModes[Position - 1].HActive * DisplayModes[Position - 1].VActive >=
+          PredefinedMode->HActive * PredefinedMode->VActive)
+      {
+        break;
+      }
+
+      CopyMem (&DisplayModes[Position], &DisplayModes[Position - 1], sizeof (DISPLAY_MODE));
+    }
+
+    CopyMem (&DisplayModes[Position], PredefinedMode, sizeof (DISPLAY_MODE));
+    ModesCount++;
+  }
+
+  return ModesCount;
+}
+
+STATIC
+UINT32
+LimitDisplayModes (
+  IN OUT DISPLAY_MODE  *DisplayModes,
+  IN     UINT32        ModesCount,
+  IN     UINT16        MaxHeight
+  )
+{
+  UINT32  Index;
+  UINT32  NewCount;
+
+  if (MaxHeight == 0) {
+    return ModesCount;
+  }
+
+  for (Index = 0, NewCount = 0; Index < ModesCount; Index++) {
+    if (DisplayModes[Index].VActive > MaxHeight) {
+      continue;
+    }
+
+    if (NewCount != Index) {
+      CopyMem (&DisplayModes[NewCount], &DisplayModes[Index], sizeof (DISPLAY_MODE));
+    }
+
+    NewCount++;
+  }
+
+  //
+  // Keep the smallest mode if none fits.
+  //
+  if (NewCount == 0) {
+    CopyMem (&DisplayModes[0], &DisplayModes[ModesCount - 1], sizeof (DISPLAY_MODE));
+    NewCount = 1;
+  }
+
+  return NewCount;
+}
+
 STATIC
 EFI_STATUS
 GetSupportedDisplayModes (
@@ -455,24 +622,26 @@ GetSupportedDisplayModes (
   CONST DISPLAY_MODE                 *Mode;
   DISPLAY_MODE_PRESET_VARSTORE_DATA  *ModePreset;
   DISPLAY_SINK_INFO                  *SinkInfo;
-
-  //
-  // Only expose a single mode to GOP.
-  //
-  Instance->Gop.Mode->MaxMode = 1;
+  BOOLEAN                            IsNative;
+  UINT32                             ModesCount;
+  UINT32                             Index;
 
   Instance->Gop.Mode->Mode = MAX_UINT32;
 
+  //
+  // Room for the selected mode plus every predefined one.
+  //
   Instance->DisplayModes = AllocateZeroPool (
                              sizeof (DISPLAY_MODE) *
-                             Instance->Gop.Mode->MaxMode
+                             (GetPredefinedDisplayModesCount () + 1)
                              );
   if (Instance->DisplayModes == NULL) {
     ASSERT (FALSE);
     return EFI_OUT_OF_RESOURCES;
   }
 
-  Mode = NULL;
+  Mode     = NULL;
+  IsNative = FALSE;
 
   ModePreset = PcdGetPtr (PcdDisplayModePreset);
   ASSERT (ModePreset != NULL);
@@ -483,7 +652,8 @@ GetSupportedDisplayModes (
       if (PrimaryDisplayState != NULL) {
         SinkInfo = &PrimaryDisplayState->ConnectorState.SinkInfo;
         if (SinkInfo->PreferredMode.OscFreq != 0) {
-          Mode = &SinkInfo->PreferredMode;
+          Mode     = &SinkInfo->PreferredMode;
+          IsNative = TRUE;
         }
       }
     } else if (ModePreset->Preset == DISPLAY_MODE_CUSTOM) {
@@ -529,10 +699,82 @@ GetSupportedDisplayModes (
   }
 
   CopyMem (&Instance->DisplayModes[0], Mode, sizeof (*Mode));
+  ModesCount = 1;
+
+  //
+  // Explicit presets only expose the chosen mode. In native mode, also offer
+  // the lower resolutions advertised by the sink so that GOP consumers can
+  // switch to them without reprobing the connector. With duplicated outputs,
+  // these must be advertised by every sink.
+  //
+  if (IsNative) {
+    ModesCount = AddAdvertisedDisplayModes (
+                   Instance,
+                   Instance->DisplayModes,
+                   ModesCount
+                   );
+  }
+
+  ModesCount = LimitDisplayModes (
+                 Instance->DisplayModes,
+                 ModesCount,
+                 PcdGet16 (PcdDisplayMaxConsoleHeight)
+                 );
+
+  Instance->Gop.Mode->MaxMode = ModesCount;
+
+  DEBUG ((DEBUG_INFO, "%a: %u mode(s):\n", __func__, ModesCount));
+  for (Index = 0; Index < ModesCount; Index++) {
+    DebugPrintDisplayMode (&Instance->DisplayModes[Index], 2, TRUE, FALSE);
+    DEBUG ((DEBUG_INFO, "\n"));
+  }
 
   return EFI_SUCCESS;
 }
 
+STATIC
+VOID
+EFIAPI
+LcdGraphicsFlushEventHandler (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  LcdGraphicsFlushDirty ((LCD_INSTANCE *)Context);
+}
+
+STATIC
+EFI_STATUS
+LcdGraphicsCreateFlushEvents (
+  IN LCD_INSTANCE  *Instance
+  )
+{
+  EFI_STATUS  Status;
+
+  Status = gBS->CreateEvent (
+                  EVT_TIMER | EVT_NOTIFY_SIGNAL,
+                  TPL_CALLBACK,
+                  LcdGraphicsFlushEventHandler,
+                  Instance,
+                  &Instance->FlushEvent
+                  );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // Whatever is still pending when the OS takes over must reach the screen,
+  // as it may keep using the framebuffer.
+  //
+  return gBS->CreateEvent (
+                EVT_SIGNAL_EXIT_BOOT_SERVICES,
+                TPL_CALLBACK,
+                LcdGraphicsFlushEventHandler,
+                Instance,
+                &Instance->ExitBootServicesEvent
+                );
+}
+
 STATIC
 VOID
 LcdGraphicsOutputDestroy (
@@ -560,6 +802,18 @@ LcdGraphicsOutputDestroy (
     FreePool (Instance->DisplayModes);
   }
 
+  if (Instance->FlushEvent != NULL) {
+    gBS->CloseEvent (Instance->FlushEvent);
+  }
+
+  if (Instance->ExitBootServicesEvent != NULL) {
+    gBS->CloseEvent (Instance->ExitBootServicesEvent);
+  }
+
+  if (Instance->ShadowBuffer != NULL) {
+    FreePages (Instance->ShadowBuffer, Instance->ShadowBufferPages);
+  }
+
   for (Index = 0; Index < Instance->DisplayStatesCount; Index++) {
     if (Instance->DisplayStates[Index] != NULL) {
       FreePool (Instance->DisplayStates[Index]);
@@ -582,6 +836,9 @@ LcdGraphicsOutputInit (
   DISPLAY_STATE  *PrimaryDisplayState;
   BOOLEAN        ForceOutput;
   BOOLEAN        DuplicateOutput;
+  UINT64         StartTime;
+
+  StartTime = GetPerformanceCounter ();
 
   Instance = AllocateCopyPool (sizeof (LCD_INSTANCE), &mLcdTemplate);
   if (Instance == NULL) {
@@ -643,6 +900,19 @@ LcdGraphicsOutputInit (
     goto Exit;
   }
 
+  if (FixedPcdGetBool (PcdDisplayShadowFramebuffer)) {
+    Status = LcdGraphicsCreateFlushEvents (Instance);
+    if (EFI_ERROR (Status)) {
+      DEBUG ((
+        DEBUG_ERROR,
+        "%a: Failed to create flush events. Status=%r\n",
+        __func__,
+        Status
+        ));
+      goto Exit;
+    }
+  }
+
   Status = gBS->InstallMultipleProtocolInterfaces (
                   &Instance->Handle,
                   &gEfiGraphicsOutputProtocolGuid,
@@ -661,6 +931,8 @@ LcdGraphicsOutputInit (
     goto Exit;
   }
 
+  DEBUG ((DEBUG_INFO, "%a: Display init took %lu ms\n", __func__, LcdGetElapsedMs (StartTime)));
+
 Exit:
   if (EFI_ERROR (Status)) {
     LcdGraphicsOutputDestroy (Instance);
@@ -814,9 +1086,11 @@ LcdGraphicsSetMode (
   EFI_GRAPHICS_OUTPUT_BLT_PIXEL  FillColour;
   LCD_INSTANCE                   *Instance;
   EFI_PHYSICAL_ADDRESS           VramBaseAddress;
+  EFI_PHYSICAL_ADDRESS           PreviousVramBaseAddress;
   UINTN                          VramSize;
   UINTN                          NumVramPages;
   UINTN                          NumPreviousVramPages;
+  UINTN                          FrameTime;
   DISPLAY_MODE                   *Mode;
   DRM_DISPLAY_MODE               *DrmMode;
   DISPLAY_STATE                  *DisplayState;
@@ -825,6 +1099,9 @@ LcdGraphicsSetMode (
   ROCKCHIP_CONNECTOR_PROTOCOL    *Connector;
   CONNECTOR_STATE                *ConnectorState;
   UINTN                          Index;
+  UINT64                         StartTime;
+
+  StartTime = GetPerformanceCounter ();
 
   Instance = LCD_INSTANCE_FROM_GOP_THIS (This);
 
@@ -846,19 +1123,20 @@ LcdGraphicsSetMode (
 
   Mode = &Instance->DisplayModes[ModeNumber];
 
-  VramBaseAddress = This->Mode->FrameBufferBase;
+  PreviousVramBaseAddress = This->Mode->FrameBufferBase;
+  VramBaseAddress         = PreviousVramBaseAddress;
 
   VramSize = Mode->HActive * Mode->VActive * RK_BYTES_PER_PIXEL;
 
   NumVramPages         = EFI_SIZE_TO_PAGES (VramSize);
-  NumPreviousVramPages = EFI_SIZE_TO_PAGES (This->Mode->FrameBufferSize);
+  NumPreviousVramPages = Instance->FrameBufferPages;
 
+  //
+  // Keep the current buffer if it is large enough. Otherwise allocate a new
+  // one and release the old one only once the VOP no longer scans it out,
+  // so a failure here leaves the current mode untouched.
+  //
   if (NumPreviousVramPages < NumVramPages) {
-    if (NumPreviousVramPages != 0) {
-      gBS->FreePages (VramBaseAddress, NumPreviousVramPages);
-      This->Mode->FrameBufferSize = 0;
-    }
-
     VramBaseAddress = SIZE_4GB - 1; // VOP2 only supports 32-bit addresses
     Status          = gBS->AllocatePages (
                              AllocateMaxAddress,
@@ -875,7 +1153,7 @@ LcdGraphicsSetMode (
         ModeNumber,
         Status
         ));
-      return Status;
+      goto EXIT;
     }
 
     Status = mCpu->SetMemoryAttributes (
@@ -891,10 +1169,44 @@ LcdGraphicsSetMode (
         __func__,
         Status
         ));
+      gBS->FreePages (VramBaseAddress, NumVramPages);
       goto EXIT;
     }
   }
 
+  //
+  // Pending shadow changes belong to the old mode and the scanout buffer
+  // is about to change, so stop flushing until the new mode is set.
+  //
+  if (Instance->FlushEvent != NULL) {
+    gBS->SetTimer (Instance->FlushEvent, TimerCancel, 0);
+  }
+
+  LcdGraphicsDiscardDirty (Instance);
+
+  //
+  // Shut down the outputs of the current mode before reprogramming them.
+  //
+  if (NumPreviousVramPages != 0) {
+    for (Index = 0; Index < Instance->DisplayStatesCount; Index++) {
+      DisplayState = Instance->DisplayStates[Index];
+      if ((DisplayState == NULL) || !DisplayState->IsEnable) {
+        continue;
+      }
+
+      Crtc      = (ROCKCHIP_CRTC_PROTOCOL *)DisplayState->CrtcState.Crtc;
+      Connector = (ROCKCHIP_CONNECTOR_PROTOCOL *)DisplayState->ConnectorState.Connector;
+
+      if (Connector->Disable != NULL) {
+        Connector->Disable (Connector, DisplayState);
+      }
+
+      if (Crtc->Disable != NULL) {
+        Crtc->Disable (Crtc, DisplayState);
+      }
+    }
+  }
+
   // Update the UEFI mode information
   This->Mode->Mode = ModeNumber;
 
@@ -905,6 +1217,26 @@ LcdGraphicsSetMode (
   This->Mode->FrameBufferBase = VramBaseAddress;
   This->Mode->FrameBufferSize = VramSize;
 
+  if (NumPreviousVramPages < NumVramPages) {
+    Instance->FrameBufferPages = NumVramPages;
+  }
+
+  //
+  // The full-screen fill below brings a new or reused shadow buffer back
+  // in sync with the scanout buffer.
+  //
+  if (FixedPcdGetBool (PcdDisplayShadowFramebuffer)) {
+    Status = LcdGraphicsAllocateShadowBuffer (Instance, VramSize);
+    if (EFI_ERROR (Status)) {
+      DEBUG ((
+        DEBUG_WARN,
+        "%a: Couldn't allocate shadow framebuffer: %r\n",
+        __func__,
+        Status
+        ));
+    }
+  }
+
   // The UEFI spec requires that we now clear the visible portions of the
   // output display to black.
 
@@ -925,6 +1257,10 @@ LcdGraphicsSetMode (
                    0
                    );
 
+  LcdGraphicsFlushDirty (Instance);
+
+  FrameTime = 0;
+
   for (Index = 0; Index < Instance->DisplayStatesCount; Index++) {
     DisplayState = Instance->DisplayStates[Index];
     if ((DisplayState == NULL) || !DisplayState->IsEnable) {
@@ -999,9 +1335,32 @@ LcdGraphicsSetMode (
     if (Connector->Enable != NULL) {
       Connector->Enable (Connector, DisplayState);
     }
+
+    FrameTime = MAX (FrameTime, (UINTN)DrmMode->HTotal * DrmMode->VTotal * 1000 / DrmMode->Clock);
+  }
+
+  //
+  // The new scanout address is latched at the next vertical blank, so wait
+  // out a full frame before releasing the old buffer.
+  //
+  if ((NumPreviousVramPages != 0) && (NumPreviousVramPages < NumVramPages)) {
+    MicroSecondDelay (FrameTime);
+    gBS->FreePages (PreviousVramBaseAddress, NumPreviousVramPages);
   }
 
+  DEBUG ((
+    DEBUG_INFO,
+    "%a: Mode %u set in %lu ms\n",
+    __func__,
+    ModeNumber,
+    LcdGetElapsedMs (StartTime)
+    ));
+
 EXIT:
+  if (Instance->FlushEvent != NULL) {
+    gBS->SetTimer (Instance->FlushEvent, TimerPeriodic, LCD_SHADOW_FLUSH_PERIOD);
+  }
+
   return Status;
 }
 
@@ -45,6 +45,28 @@ typedef struct {
   DISPLAY_STATE                           *DisplayStates[VOP_OUTPUT_IF_NUMS];
   UINT32                                  DisplayStatesCount;
   DISPLAY_MODE                            *DisplayModes;
+  //
+  // Size of the scanout buffer allocation, which may be larger than the
+  // current mode needs.
+  //
+  UINTN                                   FrameBufferPages;
+  //
+  // Cached copy of the write-combined scanout buffer. Blt operations run
+  // against it and only record the rectangle they change, FlushEvent then
+  // copies the bounding box of all changes to the scanout buffer.
+  //
+  UINT32                                  *ShadowBuffer;
+  UINTN                                   ShadowBufferPages;
+  EFI_EVENT                               FlushEvent;
+  EFI_EVENT                               ExitBootServicesEvent;
+  //
+  // Changed framebuffer area not yet flushed, in scanout pixels. Empty
+  // when DirtyRight is 0.
+  //
+  UINTN                                   DirtyLeft;
+  UINTN                                   DirtyTop;
+  UINTN                                   DirtyRight;
+  UINTN                                   DirtyBottom;
 } LCD_INSTANCE;
 
 #define LCD_INSTANCE_SIGNATURE  SIGNATURE_32('l', 'c', 'd', '0')
@@ -82,6 +104,63 @@ LcdGraphicsBlt (
   IN UINTN                              Delta       OPTIONAL
   );
 
+//
+// Blt kernels. Strides are in bytes and may be negative.
+//
+VOID
+LcdBltFillRowReference (
+  OUT UINT32  *Destination,
+  IN  UINTN   Count,
+  IN  UINT32  Value
+  );
+
+VOID
+LcdBltTranspose4x4Reference (
+  OUT UINT32        *Destination,
+  IN  INTN          DestinationStride,
+  IN  CONST UINT32  *Source,
+  IN  INTN          SourceStride
+  );
+
+#if defined (MDE_CPU_AARCH64)
+VOID
+LcdBltFillRowNeon (
+  OUT UINT32  *Destination,
+  IN  UINTN   Count,
+  IN  UINT32  Value
+  );
+
+VOID
+LcdBltTranspose4x4Neon (
+  OUT UINT32        *Destination,
+  IN  INTN          DestinationStride,
+  IN  CONST UINT32  *Source,
+  IN  INTN          SourceStride
+  );
+
+#define LcdBltFillRow       LcdBltFillRowNeon
+#define LcdBltTranspose4x4  LcdBltTranspose4x4Neon
+#else
+#define LcdBltFillRow       LcdBltFillRowReference
+#define LcdBltTranspose4x4  LcdBltTranspose4x4Reference
+#endif
+
+EFI_STATUS
+LcdGraphicsAllocateShadowBuffer (
+  IN LCD_INSTANCE  *Instance,
+  IN UINTN         Size
+  );
+
+VOID
+LcdGraphicsFlushDirty (
+  IN LCD_INSTANCE  *Instance
+  );
+
+VOID
+LcdGraphicsDiscardDirty (
+  IN LCD_INSTANCE  *Instance
+  );
+
 EFI_STATUS
 EFIAPI
 LcdGraphicsBlt90 (
@@ -136,4 +215,10 @@ EdidGetDisplaySinkInfo (
   IN CONNECTOR_STATE  *ConnectorState
   );
 
+BOOLEAN
+EdidIsPredefinedModeAdvertised (
+  IN CONNECTOR_STATE     *ConnectorState,
+  IN CONST DISPLAY_MODE  *PredefinedMode
+  );
+
 #endif /* LCD_GRAPHICS_OUTPUT_DXE_H_ */
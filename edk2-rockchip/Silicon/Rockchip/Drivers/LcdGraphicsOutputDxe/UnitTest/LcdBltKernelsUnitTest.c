@@ -0,0 +1,227 @@
+/** @file
+  Host based unit tests of the Blt kernels. On AArch64 hosts these run the
+  NEON kernels against the reference implementations.
+
+  Copyright (c) 2026, Rockchip Limited. All rights reserved.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/UnitTestLib.h>
+
+#include "../LcdGraphicsOutputDxe.h"
+
+#define UNIT_TEST_NAME     "LcdGraphicsOutputDxe Blt Kernel Unit Tests"
+#define UNIT_TEST_VERSION  "1.0"
+
+//
+// Pixels left untouched around every destination, to catch overruns.
+//
+#define GUARD_PIXELS  8
+#define GUARD_VALUE   0xDEADBEEF
+
+//
+// Longest row tried by FillRow, enough to cover the 16 pixel loop and
+// every tail length after it.
+//
+#define FILL_MAX_COUNT  67
+
+//
+// Row pitches tried by Transpose4x4, in pixels. The Blt code passes the
+// Blt buffer pitch negated when walking the rotated framebuffer.
+//
+STATIC CONST INTN  mStrides[] = { 4, 5, 16, 37, -4, -7, -16 };
+
+STATIC UINT32  mBuffer[GUARD_PIXELS + FILL_MAX_COUNT + 4 + GUARD_PIXELS];
+STATIC UINT32  mExpected[ARRAY_SIZE (mBuffer)];
+STATIC UINT32  mSource[4 * 64];
+STATIC UINT32  mTile[4 * 64];
+STATIC UINT32  mTileExpected[4 * 64];
+
+/**
+  Return a pixel value that differs between neighbouring pixels and test
+  iterations.
+**/
+STATIC
+UINT32
+PatternPixel (
+  IN UINTN  Index,
+  IN UINTN  Seed
+  )
+{
+  return (UINT32)(((Index + 1) * 0x9E3779B1U) ^ (Seed * 0x85EBCA6BU));
+}
+
+/**
+  Fill rows of every length and alignment and compare them with the
+  reference kernel, including the guard pixels on both sides.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+FillRow (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN   Count;
+  UINTN   Offset;
+  UINTN   Index;
+  UINT32  Value;
+
+  for (Count = 0; Count <= FILL_MAX_COUNT; Count++) {
+    for (Offset = 0; Offset < 4; Offset++) {
+      Value = PatternPixel (Count, Offset);
+
+      for (Index = 0; Index < ARRAY_SIZE (mBuffer); Index++) {
+        mBuffer[Index]   = GUARD_VALUE;
+        mExpected[Index] = GUARD_VALUE;
+      }
+
+      LcdBltFillRow (&mBuffer[GUARD_PIXELS + Offset], Count, Value);
+      LcdBltFillRowReference (&mExpected[GUARD_PIXELS + Offset], Count, Value);
+
+      UT_ASSERT_MEM_EQUAL (mBuffer, mExpected, sizeof (mBuffer));
+    }
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Transpose 4x4 tiles with positive and negative row pitches and check
+  each pixel, the gaps between destination rows and the source.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+Transpose4x4 (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN   SourceIndex;
+  UINTN   DestinationIndex;
+  INTN    SourceStride;
+  INTN    DestinationStride;
+  UINT32  *Source;
+  UINT32  *Destination;
+  UINT32  *Expected;
+  UINTN   Row;
+  UINTN   Column;
+  UINTN   Index;
+
+  for (SourceIndex = 0; SourceIndex < ARRAY_SIZE (mStrides); SourceIndex++) {
+    for (DestinationIndex = 0; DestinationIndex < ARRAY_SIZE (mStrides); DestinationIndex++) {
+      SourceStride      = mStrides[SourceIndex];
+      DestinationStride = mStrides[DestinationIndex];
+
+      for (Index = 0; Index < ARRAY_SIZE (mSource); Index++) {
+        mSource[Index]       = PatternPixel (Index, SourceIndex);
+        mTile[Index]         = GUARD_VALUE;
+        mTileExpected[Index] = GUARD_VALUE;
+      }
+
+      //
+      // A negative pitch walks up from the last row.
+      //
+      Source      = (SourceStride < 0) ? &mSource[3 * -SourceStride] : mSource;
+      Destination = (DestinationStride < 0) ? &mTile[3 * -DestinationStride] : mTile;
+      Expected    = (DestinationStride < 0) ? &mTileExpected[3 * -DestinationStride] : mTileExpected;
+
+      LcdBltTranspose4x4 (
+        Destination,
+        DestinationStride * RK_BYTES_PER_PIXEL,
+        Source,
+        SourceStride * RK_BYTES_PER_PIXEL
+        );
+      LcdBltTranspose4x4Reference (
+        Expected,
+        DestinationStride * RK_BYTES_PER_PIXEL,
+        Source,
+        SourceStride * RK_BYTES_PER_PIXEL
+        );
+
+      UT_ASSERT_MEM_EQUAL (mTile, mTileExpected, sizeof (mTile));
+
+      for (Row = 0; Row < 4; Row++) {
+        for (Column = 0; Column < 4; Column++) {
+          UT_ASSERT_EQUAL (
+            Destination[(INTN)Row * DestinationStride + (INTN)Column],
+            Source[(INTN)Column * SourceStride + (INTN)Row]
+            );
+        }
+      }
+
+      for (Index = 0; Index < ARRAY_SIZE (mSource); Index++) {
+        UT_ASSERT_EQUAL (mSource[Index], PatternPixel (Index, SourceIndex));
+      }
+    }
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests and run them.
+
+  @retval EFI_SUCCESS           All test cases were dispatched.
+  @retval EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                initialize the unit tests.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      KernelTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&KernelTests, Framework, "Blt Kernel Tests", "LcdGraphicsOutputDxe.BltKernels", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for Blt Kernel Tests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  AddTestCase (KernelTests, "FillRow writes exactly Count pixels", "FillRow", FillRow, NULL, NULL, NULL);
+  AddTestCase (KernelTests, "Transpose4x4 matches the reference for any pitch", "Transpose4x4", Transpose4x4, NULL, NULL, NULL);
+
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework != NULL) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return UnitTestingEntry ();
+}
@@ -21,6 +21,7 @@
 #include <Uefi/UefiBaseType.h>
 #include <Library/UefiRuntimeLib.h>
 #include <Library/BaseMemoryLib.h>
+#include <Library/DmaLib.h>
 
 #define HAL_SNOR_DEBUG
 #ifdef HAL_SNOR_DEBUG
@@ -82,6 +83,8 @@ struct FLASH_INFO {
 
 #define READ_MAX_IOSIZE  (1024 * 8)/* 8KB */
 
+#define FSPI_DMA_BUFFER_SIZE  SIZE_64KB
+
 /********************* Private Structure Definition **************************/
 
 /********************* Private Variable Definition ***************************/
@@ -209,6 +212,8 @@ static const struct FLASH_INFO  s_spiFlashbl[] = {
 STATIC struct HAL_FSPI_HOST     *g_spi;
 STATIC struct SPI_NOR           *g_nor;
 STATIC EFI_EVENT                mNorVirtualAddrChangeEvent;
+STATIC EFI_EVENT                mNorExitBootServicesEvent;
+STATIC VOID                     *mFspiDmaMapping;
 
 /* Support single line case
  * - id: get from SPI Nor device information
@@ -367,7 +372,26 @@ SNOR_EraseSec (
 }
 
 /*
- * Initiate the erasure of a single sector
+ * Initiate the erasure of a single 32KiB block
+ */
+static RETURN_STATUS
+SNOR_EraseBlk32 (
+  struct SPI_NOR  *nor,
+  UINT32          addr
+  )
+{
+  struct HAL_SPI_MEM_OP  op = HAL_SPI_MEM_OP_FORMAT (
+                                HAL_SPI_MEM_OP_CMD (nor->eraseOpcodeBlk32, 1),
+                                HAL_SPI_MEM_OP_ADDR (nor->addrWidth, addr, 1),
+                                HAL_SPI_MEM_OP_NO_DUMMY,
+                                HAL_SPI_MEM_OP_NO_DATA
+                                );
+
+  return HAL_FSPI_SpiXfer (nor->spi, &op);
+}
+
+/*
+ * Initiate the erasure of a single 64KiB block
  */
 static RETURN_STATUS
 SNOR_EraseBlk (
@@ -591,6 +615,59 @@ SNOR_ReadSFDP (
   return HAL_FSPI_SpiXfer (nor->spi, &op);
 }
 
+/*
+ * Look up the erase types in the SFDP Basic Flash Parameter Table and
+ * enable 32KiB block erase if the part supports it.
+ */
+static void
+SNOR_ProbeEraseTypes (
+  struct SPI_NOR  *nor
+  )
+{
+  UINT8   hdr[16];
+  UINT8   eraseTypes[8];
+  UINT32  tableAddr;
+  UINT32  i;
+
+  nor->eraseOpcodeBlk32 = 0;
+
+  /*
+   * The 3-byte opcodes reported by SFDP can't be used on parts that need
+   * 4-byte addressing without being switched to 4-byte mode.
+   */
+  if ((nor->addrWidth != 3) && !(nor->info->feature & FEA_4BYTE_ADDR_MODE)) {
+    return;
+  }
+
+  for (i = 0; i < sizeof (hdr); i++) {
+    if (SNOR_ReadSFDP (nor, i, &hdr[i]) != RETURN_SUCCESS) {
+      return;
+    }
+  }
+
+  /* "SFDP" signature, first parameter header must be the BFPT (ID 0x00) */
+  if ((hdr[0] != 'S') || (hdr[1] != 'F') || (hdr[2] != 'D') || (hdr[3] != 'P') ||
+      (hdr[8] != 0x00) || (hdr[11] < 9))
+  {
+    return;
+  }
+
+  tableAddr = hdr[12] | (hdr[13] << 8) | (hdr[14] << 16);
+
+  /* BFPT DWORD 8 and 9: erase type 1-4 size (2^N bytes) and opcode */
+  for (i = 0; i < sizeof (eraseTypes); i++) {
+    if (SNOR_ReadSFDP (nor, tableAddr + 28 + i, &eraseTypes[i]) != RETURN_SUCCESS) {
+      return;
+    }
+  }
+
+  for (i = 0; i < sizeof (eraseTypes); i += 2) {
+    if ((eraseTypes[i] == 15) && (eraseTypes[i + 1] != 0)) {
+      nor->eraseOpcodeBlk32 = eraseTypes[i + 1];
+    }
+  }
+}
+
 static void *
 SNOR_InfoAdjust (
   struct SPI_NOR     *nor,
@@ -638,7 +715,7 @@ HAL_SNOR_ReadData (
   }
 
   while (remain) {
-    size = MIN (READ_MAX_IOSIZE, remain);
+    size = MIN (MAX (READ_MAX_IOSIZE, nor->spi->dmaBufferSize), remain);
     ret  = SNOR_ReadData (nor, from, size, pBuf);
     if (ret != (RETURN_STATUS)size) {
       DEBUG ((DEBUG_SNOR, "%s %lu ret= %ld\n", __func__, from >> 9, ret));
@@ -714,16 +791,22 @@ HAL_SNOR_Erase (
   )
 {
   RETURN_STATUS  ret;
-  INT32          timeout[] = { 400, 2000, 40000 };
+  INT32          timeout[] = { 400, 1600, 2000, 40000 };
 
   /* DEBUG ((DEBUG_SNOR, "%s addr %lx\n", __func__, addr)); */
   if (addr >= nor->size) {
     return RETURN_DEVICE_ERROR;
   }
 
+  if ((eraseType == ERASE_BLOCK32K) && !nor->eraseOpcodeBlk32) {
+    return RETURN_UNSUPPORTED;
+  }
+
   SNOR_WriteEnable (nor);
   if (eraseType == ERASE_SECTOR) {
     ret = SNOR_EraseSec (nor, addr);
+  } else if (eraseType == ERASE_BLOCK32K) {
+    ret = SNOR_EraseBlk32 (nor, addr);
   } else if (eraseType == ERASE_BLOCK64K) {
     ret = SNOR_EraseBlk (nor, addr);
   } else {
@@ -737,6 +820,43 @@ HAL_SNOR_Erase (
   return SNOR_WaitBusy (nor, timeout[eraseType] * 1000);
 }
 
+/**
+ * @brief  Pick the largest erase operation that starts at addr and does not
+ *         go past addr + len. Walking a range with this yields the fewest
+ *         erase commands for it.
+ * @param  nor: nor dev.
+ * @param  addr: byte address, sector aligned.
+ * @param  len: number of bytes left to erase, multiple of the sector size.
+ * @param  eraseSize: number of bytes covered by the returned operation.
+ * @return NOR_ERASE_TYPE.
+ */
+NOR_ERASE_TYPE
+HAL_SNOR_PlanErase (
+  struct SPI_NOR  *nor,
+  UINT32          addr,
+  UINT32          len,
+  UINT32          *eraseSize
+  )
+{
+  if ((addr == 0) && (len >= nor->size)) {
+    *eraseSize = nor->size;
+    return ERASE_CHIP;
+  }
+
+  if (!(addr & (SIZE_64KB - 1)) && (len >= SIZE_64KB)) {
+    *eraseSize = SIZE_64KB;
+    return ERASE_BLOCK64K;
+  }
+
+  if (nor->eraseOpcodeBlk32 && !(addr & (SIZE_32KB - 1)) && (len >= SIZE_32KB)) {
+    *eraseSize = SIZE_32KB;
+    return ERASE_BLOCK32K;
+  }
+
+  *eraseSize = nor->sectorSize;
+  return ERASE_SECTOR;
+}
+
 /**
  * @brief  Flash continuous reading according to sectors.
  * @param  nor: nor dev.
@@ -952,12 +1072,15 @@ HAL_SNOR_Init (
     SNOR_Enter4byte (nor);
   }
 
+  SNOR_ProbeEraseTypes (nor);
+
   DEBUG ((DEBUG_SNOR, "nor->addrWidth: %x\n", nor->addrWidth));
   DEBUG ((DEBUG_SNOR, "nor->readProto: %x\n", nor->readProto));
   DEBUG ((DEBUG_SNOR, "nor->writeProto: %x\n", nor->writeProto));
   DEBUG ((DEBUG_SNOR, "nor->readCmd: %x\n", nor->readOpcode));
   DEBUG ((DEBUG_SNOR, "nor->programCmd: %x\n", nor->programOpcode));
   DEBUG ((DEBUG_SNOR, "nor->eraseOpcodeBlk: %x\n", nor->eraseOpcodeBlk));
+  DEBUG ((DEBUG_SNOR, "nor->eraseOpcodeBlk32: %x\n", nor->eraseOpcodeBlk32));
   DEBUG ((DEBUG_SNOR, "nor->eraseOpcodeSec: %x\n", nor->eraseOpcodeSec));
   DEBUG ((DEBUG_SNOR, "nor->size: %ldMB\n", nor->size >> 20));
   DEBUG ((DEBUG_SNOR, "nor->size: %ldMB\n", nor->size >> 20));
@@ -1067,8 +1190,9 @@ Erase (
   IN  UINT32                 ulLen
   )
 {
-  EFI_STATUS  Status;
-  UINTN       EraseSize;
+  EFI_STATUS      Status;
+  UINT32          EraseSize;
+  NOR_ERASE_TYPE  EraseType;
 
   if (EfiAtRuntime ()) {
     NorFspiEnableClock (g_nor->spi->CruBase);
@@ -1083,7 +1207,8 @@ Erase (
   }
 
   while (ulLen) {
-    Status = HAL_SNOR_Erase (g_nor, Offset, ERASE_SECTOR);
+    EraseType = HAL_SNOR_PlanErase (g_nor, Offset, ulLen, &EraseSize);
+    Status    = HAL_SNOR_Erase (g_nor, Offset, EraseType);
     if (EFI_ERROR (Status)) {
       DEBUG ((DEBUG_ERROR, "SpiFlash: Error while erase target address\n"));
       return Status;
@@ -1146,6 +1271,69 @@ Read (
   return Status;
 }
 
+typedef enum {
+  NorSectorUnchanged = 0,
+  NorSectorProgramOnly,
+  NorSectorEraseProgram
+} NOR_SECTOR_UPDATE_TYPE;
+
+typedef struct {
+  UINT32    Skipped;
+  UINT32    Programmed;
+  UINT32    Erased;
+  UINT32    BlocksErased;
+} NOR_UPDATE_STATS;
+
+STATIC NOR_UPDATE_STATS  mNorUpdateStats;
+
+/**
+ * @brief  Decide how a range of a sector must be updated.
+ * @param  Old: current flash contents.
+ * @param  New: data to be written.
+ * @param  Length: number of bytes to compare.
+ * @param  First: index of the first byte that differs.
+ * @param  Last: index of the last byte that differs.
+ * @return NorSectorUnchanged if the data already matches,
+ *         NorSectorProgramOnly if it only clears bits (1 -> 0),
+ *         NorSectorEraseProgram otherwise.
+ */
+STATIC
+NOR_SECTOR_UPDATE_TYPE
+SpiFlashClassifyUpdate (
+  IN  CONST UINT8  *Old,
+  IN  CONST UINT8  *New,
+  IN  UINTN        Length,
+  OUT UINTN        *First,
+  OUT UINTN        *Last
+  )
+{
+  NOR_SECTOR_UPDATE_TYPE  Type;
+  UINTN                   Index;
+
+  Type   = NorSectorUnchanged;
+  *First = 0;
+  *Last  = 0;
+
+  for (Index = 0; Index < Length; Index++) {
+    if (Old[Index] == New[Index]) {
+      continue;
+    }
+
+    if (Type == NorSectorUnchanged) {
+      Type   = NorSectorProgramOnly;
+      *First = Index;
+    }
+
+    *Last = Index;
+
+    if ((New[Index] & ~Old[Index]) != 0) {
+      Type = NorSectorEraseProgram;
+    }
+  }
+
+  return Type;
+}
+
 STATIC
 EFI_STATUS
 SpiFlashUpdateBlock (
@@ -1157,51 +1345,179 @@ SpiFlashUpdateBlock (
   IN UINTN   EraseSize
   )
 {
-  EFI_STATUS  Status;
+  EFI_STATUS              Status;
+  NOR_SECTOR_UPDATE_TYPE  Type;
+  UINT32                  SectorBase;
+  UINTN                   First;
+  UINTN                   Last;
 
   if (EfiAtRuntime ()) {
     NorFspiEnableClock (g_nor->spi->CruBase);
   }
 
-  // Read backup
-  if (ToUpdate != EraseSize) {
-    Status = HAL_SNOR_ReadData (g_nor, Offset - Align, TmpBuf, EraseSize);
+  SectorBase = Offset - Align;
+
+  // Read the current contents to find out what actually needs to change
+  Status = HAL_SNOR_ReadData (g_nor, SectorBase, TmpBuf, EraseSize);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "SpiFlash: Update: Error while reading old data\n"));
+    return Status;
+  }
+
+  Type = SpiFlashClassifyUpdate (&TmpBuf[Align], Buf, ToUpdate, &First, &Last);
+
+  if (Type == NorSectorUnchanged) {
+    mNorUpdateStats.Skipped++;
+    return EFI_SUCCESS;
+  }
+
+  if (Type == NorSectorProgramOnly) {
+    // Only bits going from 1 to 0, no erase needed
+    Status = HAL_SNOR_ProgData (g_nor, Offset + First, &Buf[First], Last - First + 1);
     if (EFI_ERROR (Status)) {
-      DEBUG ((DEBUG_ERROR, "SpiFlash: Update: Error while reading old data\n"));
+      DEBUG ((DEBUG_ERROR, "SpiFlash: Update: Error while writing new data\n"));
       return Status;
     }
+
+    mNorUpdateStats.Programmed++;
+    return EFI_SUCCESS;
   }
 
   // Erase entire sector
-  Status = HAL_SNOR_Erase (g_nor, Offset, ERASE_SECTOR);
+  Status = HAL_SNOR_Erase (g_nor, SectorBase, ERASE_SECTOR);
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_ERROR, "SpiFlash: Update: Error while erasing block\n"));
     return Status;
   }
 
-  if (Align) {
-    CopyMem (&TmpBuf[Align], Buf, ToUpdate);
-    Status = HAL_SNOR_ProgData (g_nor, Offset - Align, TmpBuf, EraseSize);
+  // Write the merged sector back
+  CopyMem (&TmpBuf[Align], Buf, ToUpdate);
+  Status = HAL_SNOR_ProgData (g_nor, SectorBase, TmpBuf, EraseSize);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "SpiFlash: Update: Error while writing new data\n"));
+    return Status;
+  }
+
+  mNorUpdateStats.Erased++;
+  return EFI_SUCCESS;
+}
+
+/*
+ * Update a whole erase block (32/64KiB) covered by the new data.
+ * Sectors are classified individually, but if enough of them need an
+ * erase, a single block erase is issued instead, as it takes about as
+ * long as erasing a few sectors.
+ */
+STATIC
+EFI_STATUS
+SpiFlashUpdateEraseBlock (
+  IN UINT32          Offset,
+  IN UINT8           *Buf,
+  IN UINT8           *TmpBuf,
+  IN NOR_ERASE_TYPE  EraseType,
+  IN UINT32          BlockSize
+  )
+{
+  EFI_STATUS              Status;
+  NOR_SECTOR_UPDATE_TYPE  Type;
+  UINT32                  SectorSize;
+  UINT32                  SectorOffset;
+  UINT32                  EraseCount;
+  UINT32                  PageSize;
+  UINT32                  PageOffset;
+  UINT32                  RunStart;
+  UINTN                   First;
+  UINTN                   Last;
+  UINTN                   Index;
+
+  if (EfiAtRuntime ()) {
+    NorFspiEnableClock (g_nor->spi->CruBase);
+  }
+
+  SectorSize = g_nor->sectorSize;
+  PageSize   = g_nor->pageSize;
+
+  Status = HAL_SNOR_ReadData (g_nor, Offset, TmpBuf, BlockSize);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "SpiFlash: Update: Error while reading old data\n"));
+    return Status;
+  }
+
+  EraseCount = 0;
+  for (SectorOffset = 0; SectorOffset < BlockSize; SectorOffset += SectorSize) {
+    Type = SpiFlashClassifyUpdate (&TmpBuf[SectorOffset], &Buf[SectorOffset], SectorSize, &First, &Last);
+    if (Type == NorSectorEraseProgram) {
+      EraseCount++;
+    }
+  }
+
+  if (EraseCount > (BlockSize / SectorSize) / 4) {
+    Status = HAL_SNOR_Erase (g_nor, Offset, EraseType);
     if (EFI_ERROR (Status)) {
-      DEBUG ((DEBUG_ERROR, "SpiFlash: Update: Error while writing new data\n"));
+      DEBUG ((DEBUG_ERROR, "SpiFlash: Update: Error while erasing block\n"));
       return Status;
     }
 
+    // Program every run of pages that isn't left in the erased state
+    RunStart = BlockSize;
+    for (PageOffset = 0; PageOffset <= BlockSize; PageOffset += PageSize) {
+      if (PageOffset < BlockSize) {
+        for (Index = 0; Index < PageSize; Index++) {
+          if (Buf[PageOffset + Index] != 0xFF) {
+            break;
+          }
+        }
+
+        if (Index < PageSize) {
+          if (RunStart == BlockSize) {
+            RunStart = PageOffset;
+          }
+
+          continue;
+        }
+      }
+
+      if (RunStart != BlockSize) {
+        Status = HAL_SNOR_ProgData (g_nor, Offset + RunStart, &Buf[RunStart], PageOffset - RunStart);
+        if (EFI_ERROR (Status)) {
+          DEBUG ((DEBUG_ERROR, "SpiFlash: Update: Error while writing new data\n"));
+          return Status;
+        }
+
+        RunStart = BlockSize;
+      }
+    }
+
+    mNorUpdateStats.Erased += BlockSize / SectorSize;
+    mNorUpdateStats.BlocksErased++;
     return EFI_SUCCESS;
   }
 
-  // Write new data
-  Status = HAL_SNOR_ProgData (g_nor, Offset, Buf, ToUpdate);
-  if (EFI_ERROR (Status)) {
-    DEBUG ((DEBUG_ERROR, "SpiFlash: Update: Error while writing new data\n"));
-    return Status;
-  }
+  for (SectorOffset = 0; SectorOffset < BlockSize; SectorOffset += SectorSize) {
+    Type = SpiFlashClassifyUpdate (&TmpBuf[SectorOffset], &Buf[SectorOffset], SectorSize, &First, &Last);
+
+    if (Type == NorSectorUnchanged) {
+      mNorUpdateStats.Skipped++;
+      continue;
+    }
+
+    if (Type == NorSectorEraseProgram) {
+      Status = HAL_SNOR_Erase (g_nor, Offset + SectorOffset, ERASE_SECTOR);
+      if (EFI_ERROR (Status)) {
+        DEBUG ((DEBUG_ERROR, "SpiFlash: Update: Error while erasing block\n"));
+        return Status;
+      }
 
-  // Write backup
-  if (ToUpdate != EraseSize) {
-    Status = HAL_SNOR_ProgData (g_nor, Offset + ToUpdate, &TmpBuf[ToUpdate], EraseSize - ToUpdate);
+      First = 0;
+      Last  = SectorSize - 1;
+      mNorUpdateStats.Erased++;
+    } else {
+      mNorUpdateStats.Programmed++;
+    }
+
+    Status = HAL_SNOR_ProgData (g_nor, Offset + SectorOffset + First, &Buf[SectorOffset + First], Last - First + 1);
     if (EFI_ERROR (Status)) {
-      DEBUG ((DEBUG_ERROR, "SpiFlash: Update: Error while writing backup\n"));
+      DEBUG ((DEBUG_ERROR, "SpiFlash: Update: Error while writing new data\n"));
       return Status;
     }
   }
@@ -1217,17 +1533,18 @@ Update (
   UINT32                     ulLength
   )
 {
-  EFI_STATUS  Status = EFI_SUCCESS;
-  UINT64      SectorSize, ToUpdate, Align, Scale = 1;
-  UINT8       *TmpBuf, *End;
+  EFI_STATUS      Status = EFI_SUCCESS;
+  UINT64          SectorSize, ToUpdate, Align, Scale = 1;
+  UINT8           *TmpBuf, *End;
+  NOR_ERASE_TYPE  EraseType;
+  UINT32          EraseSize;
 
   // DEBUG ((DEBUG_ERROR, "[%a]:%x %x!......................\n", __FUNCTION__, Offset, ulLength));
 
   SectorSize = g_nor->sectorSize;
-  Align      = Offset & (SectorSize -1);
   End        = Buffer + ulLength;
 
-  TmpBuf = (UINT8 *)AllocateZeroPool (SectorSize);
+  TmpBuf = (UINT8 *)AllocateZeroPool (MAX (SectorSize, SIZE_64KB));
   if (TmpBuf == NULL) {
     DEBUG ((DEBUG_ERROR, "SpiFlash: Cannot allocate memory\n"));
     return EFI_OUT_OF_RESOURCES;
@@ -1237,9 +1554,27 @@ Update (
     Scale = (End - Buffer) / 100;
   }
 
+  ZeroMem (&mNorUpdateStats, sizeof (mNorUpdateStats));
+
   for ( ; Buffer < End; Buffer += ToUpdate, Offset += ToUpdate) {
-    ToUpdate = MIN ((UINT64)(End - Buffer), SectorSize);
+    Align    = Offset & (SectorSize - 1);
+    ToUpdate = MIN ((UINT64)(End - Buffer), SectorSize - Align);
     Print (L"   \rUpdating, %d%%", 100 - (End - Buffer) / Scale);
+
+    if (Align == 0) {
+      EraseType = HAL_SNOR_PlanErase (g_nor, Offset, (UINT32)MIN ((UINT64)(End - Buffer), SIZE_64KB), &EraseSize);
+      if (EraseType != ERASE_SECTOR) {
+        ToUpdate = EraseSize;
+        Status   = SpiFlashUpdateEraseBlock (Offset, Buffer, TmpBuf, EraseType, EraseSize);
+        if (EFI_ERROR (Status)) {
+          DEBUG ((DEBUG_ERROR, "SpiFlash: Error while updating\n"));
+          break;
+        }
+
+        continue;
+      }
+    }
+
     Status = SpiFlashUpdateBlock (Offset, Align, ToUpdate, Buffer, TmpBuf, SectorSize);
 
     if (EFI_ERROR (Status)) {
@@ -1251,6 +1586,15 @@ Update (
   Print (L"\n");
   FreePool (TmpBuf);
 
+  DEBUG ((
+    DEBUG_INFO,
+    "SpiFlash: Update: %u sectors skipped, %u programmed only, %u erased (%u block erases)\n",
+    mNorUpdateStats.Skipped,
+    mNorUpdateStats.Programmed,
+    mNorUpdateStats.Erased,
+    mNorUpdateStats.BlocksErased
+    ));
+
   return Status;
 }
 
@@ -1352,6 +1696,81 @@ NorVirtualNotifyEvent (
   return;
 }
 
+/**
+  Set up a DMA bounce buffer for the FSPI controller. Data transfers fall
+  back to PIO if this fails.
+**/
+STATIC
+VOID
+NorFspiInitDma (
+  IN struct HAL_FSPI_HOST  *Host
+  )
+{
+  EFI_STATUS            Status;
+  VOID                  *Buffer;
+  UINTN                 BufferSize;
+  EFI_PHYSICAL_ADDRESS  DeviceAddress;
+
+  Status = DmaAllocateBuffer (
+             EfiBootServicesData,
+             EFI_SIZE_TO_PAGES (FSPI_DMA_BUFFER_SIZE),
+             &Buffer
+             );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_WARN, "%a: Failed to allocate DMA buffer. Status=%r\n", __FUNCTION__, Status));
+    return;
+  }
+
+  BufferSize = FSPI_DMA_BUFFER_SIZE;
+  Status     = DmaMap (
+                 MapOperationBusMasterCommonBuffer,
+                 Buffer,
+                 &BufferSize,
+                 &DeviceAddress,
+                 &mFspiDmaMapping
+                 );
+  if (EFI_ERROR (Status) || (DeviceAddress + BufferSize > SIZE_4GB)) {
+    DEBUG ((DEBUG_WARN, "%a: Failed to map DMA buffer. Status=%r\n", __FUNCTION__, Status));
+    if (!EFI_ERROR (Status)) {
+      DmaUnmap (mFspiDmaMapping);
+    }
+
+    DmaFreeBuffer (EFI_SIZE_TO_PAGES (FSPI_DMA_BUFFER_SIZE), Buffer);
+    return;
+  }
+
+  Host->dmaBuffer     = Buffer;
+  Host->dmaBufferAddr = (UINT32)DeviceAddress;
+  Host->dmaBufferSize = (UINT32)BufferSize;
+}
+
+/**
+  The DMA buffer lives in boot services memory, switch back to PIO
+  before the OS takes over.
+
+  @param[in]    Event   The Event that is being processed
+  @param[in]    Context Event Context
+**/
+STATIC
+VOID
+EFIAPI
+NorExitBootServicesEvent (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  DEBUG ((
+    DEBUG_INFO,
+    "SpiFlash: %lu bytes transferred by DMA, %lu bytes by PIO\n",
+    g_spi->dmaBytes,
+    g_spi->pioBytes
+    ));
+
+  g_spi->dmaBuffer     = NULL;
+  g_spi->dmaBufferAddr = 0;
+  g_spi->dmaBufferSize = 0;
+}
+
 EFI_STATUS
 EFIAPI
 InitializeFlash (
@@ -1373,6 +1792,7 @@ InitializeFlash (
 
   NorFspiIomux ();
   HAL_FSPI_Init (g_spi);
+  NorFspiInitDma (g_spi);
   g_nor->spi        = g_spi;
   g_nor->spi->mode  = HAL_SPI_MODE_3;
   g_nor->spi->mode |= (HAL_SPI_TX_QUAD | HAL_SPI_RX_QUAD);
@@ -1401,6 +1821,19 @@ InitializeFlash (
     goto ErrorSetMemAttr;
   }
 
+  Status = gBS->CreateEventEx (
+                  EVT_NOTIFY_SIGNAL,
+                  TPL_NOTIFY,
+                  NorExitBootServicesEvent,
+                  NULL,
+                  &gEfiEventExitBootServicesGuid,
+                  &mNorExitBootServicesEvent
+                  );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a: Failed to register ExitBootServices event\n", __FUNCTION__));
+    goto ErrorSetMemAttr;
+  }
+
   return Status;
 ErrorSetMemAttr:
   gBS->UninstallProtocolInterface (
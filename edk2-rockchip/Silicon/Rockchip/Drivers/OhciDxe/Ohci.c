@@ -115,8 +115,11 @@ OhciReset (
   }
 
   OhciSetMemoryPointer (Ohc, HC_HCCA, Ohc->HccaMemoryBlock);
-  OhciSetMemoryPointer (Ohc, HC_CONTROL_HEAD, NULL);
-  OhciSetMemoryPointer (Ohc, HC_BULK_HEAD, NULL);
+  Status = OhciInitializeAsyncLists (Ohc);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
   OhciSetHcControl (Ohc, PERIODIC_ENABLE | CONTROL_ENABLE | BULK_ENABLE, 1); /*ISOCHRONOUS_ENABLE*/
   OhciSetHcControl (Ohc, HC_FUNCTIONAL_STATE, HC_STATE_OPERATIONAL);
   gBS->Stall (50*1000);
@@ -129,6 +132,8 @@ OhciReset (
   OhciClearInterruptStatus (Ohc, START_OF_FRAME);
   gBS->Stall (1000);
 
+  OhciEnableDoneInterrupt (Ohc);
+
   return Status;
 }
 
@@ -280,7 +285,6 @@ OhciControlTransfer (
   )
 {
   USB_OHCI_HC_DEV  *Ohc;
-  ED_DESCRIPTOR    *HeadEd;
   ED_DESCRIPTOR    *Ed;
   TD_DESCRIPTOR    *HeadTd;
   TD_DESCRIPTOR    *SetupTd;
@@ -290,7 +294,6 @@ OhciControlTransfer (
   EFI_STATUS       Status;
   UINT32           DataPidDir;
   UINT32           StatusPidDir;
-  UINTN            TimeCount;
   OHCI_ED_RESULT   EdResult;
 
   DMA_MAP_OPERATION  MapOp;
@@ -337,43 +340,20 @@ OhciControlTransfer (
     StatusPidDir = TD_IN_PID;
   }
 
-  Status = OhciSetHcControl (Ohc, CONTROL_ENABLE, 0);
-  if (EFI_ERROR (Status)) {
-    DEBUG ((DEBUG_INFO, "OhciControlTransfer: fail to disable CONTROL_ENABLE\r\n"));
-    *TransferResult = EFI_USB_ERR_SYSTEM;
-    return EFI_DEVICE_ERROR;
-  }
-
-  Status = OhciSetHcCommandStatus (Ohc, CONTROL_LIST_FILLED, 0);
-  if (EFI_ERROR (Status)) {
-    DEBUG ((DEBUG_INFO, "OhciControlTransfer: fail to disable CONTROL_LIST_FILLED\r\n"));
-    *TransferResult = EFI_USB_ERR_SYSTEM;
-    return EFI_DEVICE_ERROR;
-  }
-
-  gBS->Stall (20 * 1000);
-
-  OhciSetMemoryPointer (Ohc, HC_CONTROL_HEAD, NULL);
-  Ed = OhciCreateED (Ohc);
+  //
+  // Each device keeps its own control ED on the list. It is idle (skipped,
+  // with no TDs) between transfers, so the speed and packet size can be
+  // refreshed without stopping the list, in case the address got reused.
+  //
+  Ed = OhciGetAsyncEd (Ohc, CONTROL_LIST, DeviceAddress, 0, ED_FROM_TD_DIR);
   if (Ed == NULL) {
     Status = EFI_OUT_OF_RESOURCES;
     DEBUG ((DEBUG_INFO, "OhciControlTransfer: Fail to allocate ED buffer\r\n"));
     goto CTRL_EXIT;
   }
 
-  OhciSetEDField (Ed, ED_SKIP, 1);
-  OhciSetEDField (Ed, ED_FUNC_ADD, DeviceAddress);
-  OhciSetEDField (Ed, ED_ENDPT_NUM, 0);
-  OhciSetEDField (Ed, ED_DIR, ED_FROM_TD_DIR);
   OhciSetEDField (Ed, ED_SPEED, IsSlowDevice);
-  OhciSetEDField (Ed, ED_FORMAT | ED_HALTED | ED_DTTOGGLE, 0);
   OhciSetEDField (Ed, ED_MAX_PACKET, MaxPacketLength);
-  OhciSetEDField (Ed, ED_PDATA, 0);
-  OhciSetEDField (Ed, ED_ZERO, 0);
-  OhciSetEDField (Ed, ED_TDHEAD_PTR, 0);
-  OhciSetEDField (Ed, ED_TDTAIL_PTR, 0);
-  OhciSetEDField (Ed, ED_NEXT_EDPTR, 0);
-  HeadEd = OhciAttachEDToList (Ohc, CONTROL_LIST, Ed, NULL);
   //
   // Setup Stage
   //
@@ -383,7 +363,7 @@ OhciControlTransfer (
     Status       = DmaMap (MapOp, (UINT8 *)Request, &ReqMapLength, &ReqMapPhyAddr, &ReqMapping);
     if (EFI_ERROR (Status)) {
       DEBUG ((DEBUG_INFO, "OhciControlTransfer: Fail to Map Request Buffer\r\n"));
-      goto FREE_ED_BUFF;
+      goto CTRL_EXIT;
     }
   }
 
@@ -510,24 +490,13 @@ OhciControlTransfer (
   EmptyTd->DataBuffer       = 0;
   EmptyTd->NextTDPointer    = 0;
   OhciLinkTD (HeadTd, EmptyTd);
-  Ed->TdTailPointer = (UINT32)(UINTN)EmptyTd;
-  OhciAttachTDListToED (Ed, HeadTd);
   //
   // For debugging,  dump ED & TD buffer befor transferring
   //
   //
   // OhciDumpEdTdInfo (Ohc, Ed, HeadTd, TRUE);
   //
-  OhciSetEDField (Ed, ED_SKIP, 0);
-  Status = OhciSetHcControl (Ohc, CONTROL_ENABLE, 1);
-  if (EFI_ERROR (Status)) {
-    DEBUG ((DEBUG_INFO, "OhciControlTransfer: fail to enable CONTROL_ENABLE\r\n"));
-    *TransferResult = EFI_USB_ERR_SYSTEM;
-    Status          = EFI_DEVICE_ERROR;
-    goto UNMAP_DATA_BUFF;
-  }
-
-  Status = OhciSetHcCommandStatus (Ohc, CONTROL_LIST_FILLED, 1);
+  Status = OhciQueueAsyncTransfer (Ohc, CONTROL_LIST, Ed, HeadTd, EmptyTd);
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_INFO, "OhciControlTransfer: fail to enable CONTROL_LIST_FILLED\r\n"));
     *TransferResult = EFI_USB_ERR_SYSTEM;
@@ -535,16 +504,7 @@ OhciControlTransfer (
     goto UNMAP_DATA_BUFF;
   }
 
-  gBS->Stall (20 * 1000);
-
-  TimeCount = 0;
-  Status    = CheckIfDone (Ohc, CONTROL_LIST, Ed, HeadTd, &EdResult);
-
-  while (Status == EFI_NOT_READY && TimeCount <= TimeOut) {
-    gBS->Stall (1000);
-    TimeCount++;
-    Status = CheckIfDone (Ohc, CONTROL_LIST, Ed, HeadTd, &EdResult);
-  }
+  Status = OhciWaitForAsyncTransfer (Ohc, CONTROL_LIST, Ed, HeadTd, TimeOut, &EdResult);
 
   //
   // For debugging, dump ED & TD buffer after transferring
@@ -566,12 +526,7 @@ OhciControlTransfer (
   }
 
 UNMAP_DATA_BUFF:
-  OhciSetEDField (Ed, ED_SKIP, 1);
-  if (HeadEd == Ed) {
-    OhciSetMemoryPointer (Ohc, HC_CONTROL_HEAD, NULL);
-  } else {
-    HeadEd->NextED = Ed->NextED;
-  }
+  OhciRetireAsyncTransfer (Ohc, Ed);
 
   if (DataMapping != NULL) {
     DmaUnmap (DataMapping);
@@ -581,7 +536,7 @@ FREE_TD_BUFF:
   while (HeadTd) {
     DataTd = HeadTd;
     HeadTd = (TD_DESCRIPTOR *)(UINTN)(HeadTd->NextTDPointer);
-    UsbHcFreeMem (Ohc->MemPool, DataTd, sizeof (TD_DESCRIPTOR));
+    OhciFreeTD (Ohc, DataTd);
   }
 
 UNMAP_SETUP_BUFF:
@@ -589,9 +544,6 @@ UNMAP_SETUP_BUFF:
     DmaUnmap (ReqMapping);
   }
 
-FREE_ED_BUFF:
-  UsbHcFreeMem (Ohc->MemPool, Ed, sizeof (ED_DESCRIPTOR));
-
 CTRL_EXIT:
   return Status;
 }
@@ -649,7 +601,6 @@ OhciBulkTransfer (
   )
 {
   USB_OHCI_HC_DEV  *Ohc;
-  ED_DESCRIPTOR    *HeadEd;
   ED_DESCRIPTOR    *Ed;
   UINT32           DataPidDir;
   TD_DESCRIPTOR    *HeadTd;
@@ -657,7 +608,7 @@ OhciBulkTransfer (
   TD_DESCRIPTOR    *EmptyTd;
   EFI_STATUS       Status;
   UINT8            EndPointNum;
-  UINTN            TimeCount;
+  UINT8            EdDir;
   OHCI_ED_RESULT   EdResult;
 
   DMA_MAP_OPERATION     MapOp;
@@ -686,58 +637,38 @@ OhciBulkTransfer (
 
   if ((EndPointAddress & 0x80) != 0) {
     DataPidDir = TD_IN_PID;
+    EdDir      = ED_IN_DIR;
     MapOp      = MapOperationBusMasterWrite;
   } else {
     DataPidDir = TD_OUT_PID;
+    EdDir      = ED_OUT_DIR;
     MapOp      = MapOperationBusMasterRead;
   }
 
   EndPointNum         = (EndPointAddress & 0xF);
   EdResult.NextToggle = *DataToggle;
 
-  Status = OhciSetHcControl (Ohc, BULK_ENABLE, 0);
-  if (EFI_ERROR (Status)) {
-    DEBUG ((DEBUG_INFO, "OhciControlTransfer: fail to disable BULK_ENABLE\r\n"));
-    *TransferResult = EFI_USB_ERR_SYSTEM;
-    return EFI_DEVICE_ERROR;
-  }
-
-  Status = OhciSetHcCommandStatus (Ohc, BULK_LIST_FILLED, 0);
-  if (EFI_ERROR (Status)) {
-    DEBUG ((DEBUG_INFO, "OhciControlTransfer: fail to disable BULK_LIST_FILLED\r\n"));
-    *TransferResult = EFI_USB_ERR_SYSTEM;
-    return EFI_DEVICE_ERROR;
-  }
-
-  gBS->Stall (20 * 1000);
-
-  OhciSetMemoryPointer (Ohc, HC_BULK_HEAD, NULL);
-
-  Ed = OhciCreateED (Ohc);
+  //
+  // Every bulk endpoint keeps its own ED on the list, so transfers to
+  // different endpoints can be queued at the same time. The data toggle
+  // is carried by the ED across the TDs of a transfer.
+  //
+  Ed = OhciGetAsyncEd (Ohc, BULK_LIST, DeviceAddress, EndPointNum, EdDir);
   if (Ed == NULL) {
+    DEBUG ((DEBUG_INFO, "OhciBulkTransfer: Fail to allocate ED buffer\r\n"));
     return EFI_OUT_OF_RESOURCES;
   }
 
-  OhciSetEDField (Ed, ED_SKIP, 1);
-  OhciSetEDField (Ed, ED_FUNC_ADD, DeviceAddress);
-  OhciSetEDField (Ed, ED_ENDPT_NUM, EndPointNum);
-  OhciSetEDField (Ed, ED_DIR, ED_FROM_TD_DIR);
   OhciSetEDField (Ed, ED_SPEED, HI_SPEED);
-  OhciSetEDField (Ed, ED_FORMAT | ED_HALTED | ED_DTTOGGLE, 0);
   OhciSetEDField (Ed, ED_MAX_PACKET, MaxPacketLength);
-  OhciSetEDField (Ed, ED_PDATA, 0);
-  OhciSetEDField (Ed, ED_ZERO, 0);
-  OhciSetEDField (Ed, ED_TDHEAD_PTR, 0);
-  OhciSetEDField (Ed, ED_TDTAIL_PTR, 0);
-  OhciSetEDField (Ed, ED_NEXT_EDPTR, 0);
-  HeadEd = OhciAttachEDToList (Ohc, BULK_LIST, Ed, NULL);
+  OhciSetEDField (Ed, ED_DTTOGGLE, *DataToggle);
 
   if (Data != NULL) {
     MapLength = *DataLength;
     Status    = DmaMap (MapOp, (UINT8 *)Data, &MapLength, &MapPyhAddr, &Mapping);
     if (EFI_ERROR (Status)) {
       DEBUG ((DEBUG_INFO, "OhciBulkTransfer: Fail to Map Data Buffer for Bulk\r\n"));
-      goto FREE_ED_BUFF;
+      return Status;
     }
   }
 
@@ -765,7 +696,10 @@ OhciBulkTransfer (
     OhciSetTDField (DataTd, TD_BUFFER_ROUND, 1);
     OhciSetTDField (DataTd, TD_DIR_PID, DataPidDir);
     OhciSetTDField (DataTd, TD_DELAY_INT, TD_NO_DELAY);
-    OhciSetTDField (DataTd, TD_DT_TOGGLE, *DataToggle);
+    //
+    // Take the toggle from the ED's toggle carry.
+    //
+    DataTd->Word0.DataToggle = 0;
     OhciSetTDField (DataTd, TD_ERROR_CNT, 0);
     OhciSetTDField (DataTd, TD_COND_CODE, TD_TOBE_PROCESSED);
     OhciSetTDField (DataTd, TD_CURR_BUFFER_PTR, (UINT32)MapPyhAddr);
@@ -781,9 +715,8 @@ OhciBulkTransfer (
       OhciLinkTD (HeadTd, DataTd);
     }
 
-    *DataToggle ^= 1;
-    MapPyhAddr  += ActualSendLength;
-    LeftLength  -= ActualSendLength;
+    MapPyhAddr += ActualSendLength;
+    LeftLength -= ActualSendLength;
   }
 
   //
@@ -811,35 +744,16 @@ OhciBulkTransfer (
   EmptyTd->DataBuffer       = 0;
   EmptyTd->NextTDPointer    = 0;
   OhciLinkTD (HeadTd, EmptyTd);
-  Ed->TdTailPointer = (UINT32)(UINTN)EmptyTd;
-  OhciAttachTDListToED (Ed, HeadTd);
-
-  OhciSetEDField (Ed, ED_SKIP, 0);
-  Status = OhciSetHcCommandStatus (Ohc, BULK_LIST_FILLED, 1);
-  if (EFI_ERROR (Status)) {
-    *TransferResult = EFI_USB_ERR_SYSTEM;
-    Status          = EFI_DEVICE_ERROR;
-    DEBUG ((DEBUG_INFO, "OhciControlTransfer: Fail to enable BULK_LIST_FILLED\r\n"));
-    goto FREE_OHCI_TDBUFF;
-  }
 
-  Status = OhciSetHcControl (Ohc, BULK_ENABLE, 1);
+  Status = OhciQueueAsyncTransfer (Ohc, BULK_LIST, Ed, HeadTd, EmptyTd);
   if (EFI_ERROR (Status)) {
     *TransferResult = EFI_USB_ERR_SYSTEM;
     Status          = EFI_DEVICE_ERROR;
-    DEBUG ((DEBUG_INFO, "OhciControlTransfer: Fail to enable BULK_ENABLE\r\n"));
+    DEBUG ((DEBUG_INFO, "OhciBulkTransfer: Fail to enable BULK_LIST_FILLED\r\n"));
     goto FREE_OHCI_TDBUFF;
   }
 
-  gBS->Stall (20 * 1000);
-
-  TimeCount = 0;
-  Status    = CheckIfDone (Ohc, BULK_LIST, Ed, HeadTd, &EdResult);
-  while (Status == EFI_NOT_READY && TimeCount <= TimeOut) {
-    gBS->Stall (1000);
-    TimeCount++;
-    Status = CheckIfDone (Ohc, BULK_LIST, Ed, HeadTd, &EdResult);
-  }
+  Status = OhciWaitForAsyncTransfer (Ohc, BULK_LIST, Ed, HeadTd, TimeOut, &EdResult);
 
   *TransferResult = ConvertErrorCode (EdResult.ErrorCode);
 
@@ -848,7 +762,6 @@ OhciBulkTransfer (
       DEBUG ((DEBUG_ERROR, "Bulk pipe timeout, > %d mS\r\n", TimeOut));
     } else {
       DEBUG ((DEBUG_ERROR, "Bulk pipe broken\r\n"));
-      *DataToggle = EdResult.NextToggle;
     }
 
     *DataLength = 0;
@@ -856,29 +769,25 @@ OhciBulkTransfer (
     DEBUG ((DEBUG_INFO, "Bulk transfer successed\r\n"));
   }
 
-  // *DataToggle = (UINT8) OhciGetEDField (Ed, ED_DTTOGGLE);
-
 FREE_OHCI_TDBUFF:
-  OhciSetEDField (Ed, ED_SKIP, 1);
-  if (HeadEd == Ed) {
-    OhciSetMemoryPointer (Ohc, HC_BULK_HEAD, NULL);
-  } else {
-    HeadEd->NextED = Ed->NextED;
-  }
+  OhciRetireAsyncTransfer (Ohc, Ed);
+
+  //
+  // The HC updates the toggle carry with every retired TD, so it holds the
+  // next toggle even after a short packet, error or timeout.
+  //
+  *DataToggle = (UINT8)OhciGetEDField (Ed, ED_DTTOGGLE);
 
   while (HeadTd) {
     DataTd = HeadTd;
     HeadTd = (TD_DESCRIPTOR *)(UINTN)(HeadTd->NextTDPointer);
-    UsbHcFreeMem (Ohc->MemPool, DataTd, sizeof (TD_DESCRIPTOR));
+    OhciFreeTD (Ohc, DataTd);
   }
 
   if (Mapping != NULL) {
     DmaUnmap (Mapping);
   }
 
-FREE_ED_BUFF:
-  UsbHcFreeMem (Ohc->MemPool, Ed, sizeof (ED_DESCRIPTOR));
-
   return Status;
 }
 
@@ -1069,7 +978,11 @@ OhciInterruptTransfer (
     OhciSetTDField (DataTd, TD_PDATA, 0);
     OhciSetTDField (DataTd, TD_BUFFER_ROUND, 1);
     OhciSetTDField (DataTd, TD_DIR_PID, DataPidDir);
-    OhciSetTDField (DataTd, TD_DELAY_INT, TD_NO_DELAY);
+    //
+    // Asynchronous transfers request the done queue interrupt on
+    // completion, so they are serviced without waiting for the timer.
+    //
+    OhciSetTDField (DataTd, TD_DELAY_INT, (CallBackFunction != NULL) ? 0 : TD_NO_DELAY);
     OhciSetTDField (DataTd, TD_DT_TOGGLE, *DataToggle);
     OhciSetTDField (DataTd, TD_ERROR_CNT, 0);
     OhciSetTDField (DataTd, TD_COND_CODE, TD_TOBE_PROCESSED);
@@ -1161,7 +1074,7 @@ FREE_OHCI_TDBUFF:
   while (HeadTd) {
     DataTd = HeadTd;
     HeadTd = (TD_DESCRIPTOR *)(UINTN)(HeadTd->NextTDPointer);
-    UsbHcFreeMem (Ohc->MemPool, DataTd, sizeof (TD_DESCRIPTOR));
+    OhciFreeTD (Ohc, DataTd);
   }
 
   // FREE_OHCI_EDBUFF:
@@ -2015,8 +1928,11 @@ OhcInitHC (
   }
 
   OhciSetMemoryPointer (Ohc, HC_HCCA, Ohc->HccaMemoryBlock);
-  OhciSetMemoryPointer (Ohc, HC_CONTROL_HEAD, NULL);
-  OhciSetMemoryPointer (Ohc, HC_BULK_HEAD, NULL);
+  Status = OhciInitializeAsyncLists (Ohc);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
   OhciSetHcControl (Ohc, PERIODIC_ENABLE | CONTROL_ENABLE | BULK_ENABLE, 1);
   OhciSetHcControl (Ohc, HC_FUNCTIONAL_STATE, HC_STATE_OPERATIONAL);
 
@@ -2029,6 +1945,8 @@ OhcInitHC (
   OhciClearInterruptStatus (Ohc, START_OF_FRAME);
   gBS->Stall (1000);
 
+  OhciEnableDoneInterrupt (Ohc);
+
   return EFI_SUCCESS;
 }
 
@@ -2044,7 +1962,9 @@ OhciFreeDev (
   IN USB_OHCI_HC_DEV  *Ohc
   )
 {
+  OhciUnregisterDoneInterrupt (Ohc);
   OhciFreeFixedIntMemory (Ohc);
+  OhciFreeAsyncLists (Ohc);
 
   if (Ohc->HouseKeeperTimer != NULL) {
     gBS->CloseEvent (Ohc->HouseKeeperTimer);
@@ -2103,6 +2023,7 @@ OhciCleanDevUp (
   // Cancel the timer event
   //
   gBS->SetTimer (Ohc->HouseKeeperTimer, TimerCancel, 0);
+  OhciUnregisterDoneInterrupt (Ohc);
 
   //
   // Stop the host controller
@@ -2111,6 +2032,8 @@ OhciCleanDevUp (
   This->Reset (This, EFI_USB_HC_RESET_GLOBAL);
   This->SetState (This, EfiUsbHcStateHalt);
 
+  OhciDumpTransferLatency (Ohc);
+
   //
   // Free resources
   //
@@ -2142,6 +2065,9 @@ OhcExitBootService (
   Ohc = (USB_OHCI_HC_DEV *)Context;
 
   UsbHc = &Ohc->UsbHc;
+
+  OhciDumpTransferLatency (Ohc);
+
   //
   // Stop the Host Controller
   //
@@ -2149,6 +2075,7 @@ OhcExitBootService (
   OhciSetHcControl (Ohc, PERIODIC_ENABLE | CONTROL_ENABLE | ISOCHRONOUS_ENABLE | BULK_ENABLE, 0);
   UsbHc->Reset (UsbHc, EFI_USB_HC_RESET_GLOBAL);
   UsbHc->SetState (UsbHc, EfiUsbHcStateHalt);
+  OhciDisableDoneInterrupt (Ohc);
 
   return;
 }
@@ -2228,6 +2155,7 @@ OHCIDriverBindingStart (
   VOID                  *Map;
   UINTN                 Pages;
   UINTN                 Bytes;
+  UINT64                TimerPeriod;
 
   Ohc = AllocateZeroPool (sizeof (USB_OHCI_HC_DEV));
   if (Ohc == NULL) {
@@ -2277,12 +2205,18 @@ OHCIDriverBindingStart (
   Ohc->InterruptContextList           = NULL;
   Ohc->ControllerNameTable            = NULL;
   Ohc->HouseKeeperTimer               = NULL;
+  Ohc->DoneQueueEvent                 = NULL;
 
   Ohc->MemPool = UsbHcInitMemPool (TRUE, 0);
   if (Ohc->MemPool == NULL) {
     goto FREE_DEV_BUFFER;
   }
 
+  Status = OhciFillTDFreeList (Ohc, OHCI_TD_FREE_LIST_INITIAL);
+  if (EFI_ERROR (Status)) {
+    goto FREE_MEM_POOL;
+  }
+
   Bytes = 4096;
   Pages = EFI_SIZE_TO_PAGES (Bytes);
 
@@ -2364,16 +2298,28 @@ OHCIDriverBindingStart (
     goto UNINSTALL_USBHC;
   }
 
-  Status = gBS->SetTimer (Ohc->HouseKeeperTimer, TimerPeriodic, 10 * 1000 * 10);
+  //
+  // Use the done queue interrupt when it is available, keeping a slower
+  // timer as a fallback for completions it doesn't report.
+  //
+  TimerPeriod = OHCI_HOUSEKEEPER_INTERVAL;
+  Status      = OhciRegisterDoneInterrupt (Ohc);
+  if (!EFI_ERROR (Status)) {
+    OhciEnableDoneInterrupt (Ohc);
+    TimerPeriod = OHCI_HOUSEKEEPER_FALLBACK_INTERVAL;
+  }
+
+  Status = gBS->SetTimer (Ohc->HouseKeeperTimer, TimerPeriodic, TimerPeriod);
   if (EFI_ERROR (Status)) {
     goto FREE_OHC;
   }
 
   DEBUG ((
     DEBUG_INFO,
-    "OHCI started for controller @ %p, base address: 0x%p\n",
+    "OHCI started for controller @ %p, base address: 0x%p, %a\n",
     ControllerHandle,
-    Ohc->UsbHcBaseAddress
+    Ohc->UsbHcBaseAddress,
+    (Ohc->DoneQueueEvent != NULL) ? "interrupt driven" : "polled"
     ));
   return EFI_SUCCESS;
 
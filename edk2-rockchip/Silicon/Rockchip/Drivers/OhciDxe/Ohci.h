@@ -14,6 +14,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Uefi.h>
 
 #include <Protocol/UsbHostController.h>
+#include <Protocol/HardwareInterrupt.h>
 #include <Library/DmaLib.h>
 
 #include <Guid/EventGroup.h>
@@ -27,6 +28,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/IoLib.h>
 #include <Library/DebugLib.h>
 #include <Library/BaseMemoryLib.h>
+#include <Library/TimerLib.h>
 
 #include <Protocol/OhciDeviceProtocol.h>
 
@@ -73,9 +75,31 @@ struct _USB_OHCI_HC_DEV {
   INTERRUPT_CONTEXT_ENTRY     *InterruptContextList;
   VOID                        *MemPool;
 
+  //
+  // Persistent heads of the control and bulk lists. The EDs of the
+  // endpoints used so far are cached behind them.
+  //
+  ED_DESCRIPTOR               *ControlEd;
+  ED_DESCRIPTOR               *BulkEd;
+
+  //
+  // Recycled TDs, chained through NextTDPointer.
+  //
+  TD_DESCRIPTOR               *FreeTdList;
+  UINTN                       FreeTdCount;
+  OHCI_LATENCY_HISTOGRAM      Latency[2];
+
   UINT32                      ToggleFlag;
 
   EFI_EVENT                   HouseKeeperTimer;
+
+  //
+  // Signalled by the interrupt handler when the controller writes back
+  // the done queue. NULL when the interrupt isn't used.
+  //
+  EFI_EVENT                   DoneQueueEvent;
+  HARDWARE_INTERRUPT_SOURCE   InterruptSource;
+
   //
   // ExitBootServicesEvent is used to stop the OHC DMA operation
   // after exit boot service.
@@ -88,3 +88,40 @@ OhciDumpReg (
     DEBUG ((DEBUG_INFO, "OhcDumpReg 0x%x = 0x%x\n", Ohc->UsbHcBaseAddress +0x04*i, Data));
   }
 }
+
+/*++
+
+  Print the control and bulk transfer latency histograms
+
+  @param  Ohc                   Pointer to OHCI private data
+
+**/
+VOID
+OhciDumpTransferLatency (
+  IN USB_OHCI_HC_DEV  *Ohc
+  )
+{
+  STATIC CONST CHAR8  *ListName[] = { "Control", "Bulk" };
+  UINTN               List;
+  UINTN               Index;
+
+  for (List = 0; List < ARRAY_SIZE (Ohc->Latency); List++) {
+    DEBUG ((DEBUG_INFO, "OHCI %a transfer latency @ 0x%x:\n", ListName[List], Ohc->UsbHcBaseAddress));
+    for (Index = 0; Index < OHCI_LATENCY_BUCKETS - 1; Index++) {
+      DEBUG ((
+        DEBUG_INFO,
+        "  < %6u us: %u\n",
+        OHCI_LATENCY_BUCKET_BASE << Index,
+        Ohc->Latency[List].Count[Index]
+        ));
+    }
+
+    DEBUG ((
+      DEBUG_INFO,
+      "  >= %5u us: %u\n",
+      OHCI_LATENCY_BUCKET_BASE << (OHCI_LATENCY_BUCKETS - 2),
+      Ohc->Latency[List].Count[OHCI_LATENCY_BUCKETS - 1]
+      ));
+    DEBUG ((DEBUG_INFO, "  timeouts  : %u\n", Ohc->Latency[List].Timeouts));
+  }
+}
@@ -41,3 +41,16 @@ VOID
 OhciDumpReg (
   IN USB_OHCI_HC_DEV  *Ohc
   );
+
+/*++
+
+  Print the control and bulk transfer latency histograms
+
+  @param  Ohc                   Pointer to OHCI private data
+
+**/
+
+VOID
+OhciDumpTransferLatency (
+  IN USB_OHCI_HC_DEV  *Ohc
+  );
@@ -81,7 +81,7 @@ OhciFreeInterruptContextEntry (
   while (Entry->DataTd) {
     Td            = Entry->DataTd;
     Entry->DataTd = (TD_DESCRIPTOR *)(UINTN)(Entry->DataTd->NextTDPointer);
-    UsbHcFreeMem (Ohc->MemPool, Td, sizeof (TD_DESCRIPTOR));
+    OhciFreeTD (Ohc, Td);
   }
 
   FreePool (Entry);
@@ -313,16 +313,20 @@ CheckIfDone (
 
   switch (ListType) {
     case CONTROL_LIST:
-      if (OhciGetHcCommandStatus (Ohc, CONTROL_LIST_FILLED) != 0) {
-        return EFI_NOT_READY;
-      }
-
-      break;
     case BULK_LIST:
-      if (OhciGetHcCommandStatus (Ohc, BULK_LIST_FILLED) != 0) {
+      //
+      // The HC only advances the ED head pointer once it has retired a TD,
+      // so the transfer is over as soon as the head reaches the tail or
+      // the ED gets halted by an error. There is no need to wait for the
+      // list filled bit, which is only cleared on the next list pass.
+      //
+      if ((OhciGetEDField (Ed, ED_HALTED) == 0) &&
+          (OhciGetEDField (Ed, ED_TDHEAD_PTR) != OhciGetEDField (Ed, ED_TDTAIL_PTR)))
+      {
         return EFI_NOT_READY;
       }
 
+      MemoryFence ();
       break;
     default:
       break;
@@ -339,6 +343,371 @@ CheckIfDone (
   }
 }
 
+/**
+
+  Wait for the host controller to start a new frame.
+
+  @param  Ohc                   UHC private data
+
+  @retval EFI_SUCCESS           A new frame started
+  @retval EFI_TIMEOUT           No SOF was seen in time
+
+**/
+STATIC
+EFI_STATUS
+OhciWaitForNextFrame (
+  IN USB_OHCI_HC_DEV  *Ohc
+  )
+{
+  UINTN  Index;
+
+  OhciClearInterruptStatus (Ohc, START_OF_FRAME);
+
+  for (Index = 0; Index < OHCI_SOF_TIMEOUT / OHCI_ASYNC_POLL_INTERVAL; Index++) {
+    if (OhciGetHcInterruptStatus (Ohc, START_OF_FRAME) != 0) {
+      return EFI_SUCCESS;
+    }
+
+    gBS->Stall (OHCI_ASYNC_POLL_INTERVAL);
+  }
+
+  return EFI_TIMEOUT;
+}
+
+/**
+
+  Reset a control or bulk ED to the idle state. The toggle
+  carry is preserved.
+
+  @param  Ed                    ED to reset
+
+**/
+STATIC
+VOID
+OhciResetAsyncEd (
+  IN ED_DESCRIPTOR  *Ed
+  )
+{
+  OhciSetEDField (Ed, ED_SKIP, 1);
+  OhciSetEDField (Ed, ED_HALTED | ED_TDHEAD_PTR | ED_TDTAIL_PTR, 0);
+}
+
+/**
+
+  Free all the endpoint EDs cached behind a control or bulk list head.
+  The host controller must not be processing the list.
+
+  @param  Ohc                   UHC private data
+  @param  HeadEd                Head of the list
+
+**/
+STATIC
+VOID
+OhciFreeAsyncEds (
+  IN USB_OHCI_HC_DEV  *Ohc,
+  IN ED_DESCRIPTOR    *HeadEd
+  )
+{
+  ED_DESCRIPTOR  *Ed;
+
+  while (HeadEd->NextED != 0) {
+    Ed             = (ED_DESCRIPTOR *)(UINTN)HeadEd->NextED;
+    HeadEd->NextED = Ed->NextED;
+    OhciFreeED (Ohc, Ed);
+  }
+}
+
+/**
+
+  Set up the persistent EDs at the head of the control and bulk lists.
+
+  @param  Ohc                   UHC private data
+
+  @retval EFI_SUCCESS           Lists initialized
+  @retval EFI_OUT_OF_RESOURCES  Failed to allocate the EDs
+
+**/
+EFI_STATUS
+OhciInitializeAsyncLists (
+  IN USB_OHCI_HC_DEV  *Ohc
+  )
+{
+  if (Ohc->ControlEd == NULL) {
+    Ohc->ControlEd = OhciCreateED (Ohc);
+    if (Ohc->ControlEd == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+  }
+
+  if (Ohc->BulkEd == NULL) {
+    Ohc->BulkEd = OhciCreateED (Ohc);
+    if (Ohc->BulkEd == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+  }
+
+  //
+  // The list heads never carry TDs, they only anchor the endpoint EDs.
+  //
+  OhciFreeAsyncEds (Ohc, Ohc->ControlEd);
+  OhciFreeAsyncEds (Ohc, Ohc->BulkEd);
+  OhciResetAsyncEd (Ohc->ControlEd);
+  OhciResetAsyncEd (Ohc->BulkEd);
+
+  OhciSetMemoryPointer (Ohc, HC_CONTROL_HEAD, Ohc->ControlEd);
+  OhciSetMemoryPointer (Ohc, HC_BULK_HEAD, Ohc->BulkEd);
+
+  return EFI_SUCCESS;
+}
+
+/**
+
+  Free the control and bulk lists, including the cached endpoint EDs.
+  The host controller must not be processing the lists.
+
+  @param  Ohc                   UHC private data
+
+**/
+VOID
+OhciFreeAsyncLists (
+  IN USB_OHCI_HC_DEV  *Ohc
+  )
+{
+  if (Ohc->ControlEd != NULL) {
+    OhciFreeAsyncEds (Ohc, Ohc->ControlEd);
+    OhciFreeED (Ohc, Ohc->ControlEd);
+    Ohc->ControlEd = NULL;
+  }
+
+  if (Ohc->BulkEd != NULL) {
+    OhciFreeAsyncEds (Ohc, Ohc->BulkEd);
+    OhciFreeED (Ohc, Ohc->BulkEd);
+    Ohc->BulkEd = NULL;
+  }
+}
+
+/**
+
+  Look up the ED of an endpoint on the control or bulk list, creating and
+  linking a new one on first use. The ED then stays on the list, so that
+  later transfers to the same endpoint reuse it.
+
+  @param  Ohc                   UHC private data
+  @param  ListType              Pipe type
+  @param  DeviceAddress         Device address of the endpoint
+  @param  EndPointNum           Endpoint number
+  @param  EdDir                 ED direction
+
+  @retval                       The endpoint ED, or NULL if out of resources
+
+**/
+ED_DESCRIPTOR *
+OhciGetAsyncEd (
+  IN USB_OHCI_HC_DEV       *Ohc,
+  IN DESCRIPTOR_LIST_TYPE  ListType,
+  IN UINT8                 DeviceAddress,
+  IN UINT8                 EndPointNum,
+  IN UINT8                 EdDir
+  )
+{
+  ED_DESCRIPTOR  *HeadEd;
+  ED_DESCRIPTOR  *Ed;
+
+  HeadEd = (ListType == CONTROL_LIST) ? Ohc->ControlEd : Ohc->BulkEd;
+
+  for (Ed = (ED_DESCRIPTOR *)(UINTN)HeadEd->NextED; Ed != NULL; Ed = (ED_DESCRIPTOR *)(UINTN)Ed->NextED) {
+    if ((Ed->Word0.FunctionAddress == DeviceAddress) &&
+        (Ed->Word0.EndPointNum == EndPointNum) &&
+        (Ed->Word0.Direction == EdDir))
+    {
+      return Ed;
+    }
+  }
+
+  Ed = OhciCreateED (Ohc);
+  if (Ed == NULL) {
+    return NULL;
+  }
+
+  OhciSetEDField (Ed, ED_SKIP, 1);
+  OhciSetEDField (Ed, ED_FUNC_ADD, DeviceAddress);
+  OhciSetEDField (Ed, ED_ENDPT_NUM, EndPointNum);
+  OhciSetEDField (Ed, ED_DIR, EdDir);
+  OhciSetEDField (Ed, ED_FORMAT | ED_PDATA | ED_ZERO, 0);
+  OhciSetEDField (Ed, ED_HALTED | ED_DTTOGGLE | ED_TDHEAD_PTR | ED_TDTAIL_PTR, 0);
+
+  //
+  // Link the new ED right behind the list head. The HC may be walking the
+  // list, so it must be complete before it becomes reachable.
+  //
+  OhciSetEDField (Ed, ED_NEXT_EDPTR, HeadEd->NextED);
+  MemoryFence ();
+  OhciSetEDField (HeadEd, ED_NEXT_EDPTR, (UINT32)(UINTN)Ed);
+
+  return Ed;
+}
+
+/**
+
+  Hand a TD list over to an endpoint ED on the control or bulk list.
+
+  @param  Ohc                   UHC private data
+  @param  ListType              Pipe type
+  @param  Ed                    Endpoint ED
+  @param  HeadTd                First TD of the transfer
+  @param  TailTd                Empty TD terminating the transfer
+
+  @retval EFI_SUCCESS           Transfer queued
+  @retval EFI_DEVICE_ERROR      Failed to notify the host controller
+
+**/
+EFI_STATUS
+OhciQueueAsyncTransfer (
+  IN USB_OHCI_HC_DEV       *Ohc,
+  IN DESCRIPTOR_LIST_TYPE  ListType,
+  IN ED_DESCRIPTOR         *Ed,
+  IN TD_DESCRIPTOR         *HeadTd,
+  IN TD_DESCRIPTOR         *TailTd
+  )
+{
+  //
+  // The ED is skipped while idle, so the HC does not look at it until the
+  // new TD list is fully in place.
+  //
+  OhciSetEDField (Ed, ED_TDTAIL_PTR, (UINT32)(UINTN)TailTd);
+  OhciSetEDField (Ed, ED_HALTED, 0);
+  OhciSetEDField (Ed, ED_TDHEAD_PTR, (UINT32)(UINTN)HeadTd);
+  MemoryFence ();
+  OhciSetEDField (Ed, ED_SKIP, 0);
+  MemoryFence ();
+
+  return OhciSetHcCommandStatus (
+           Ohc,
+           (ListType == CONTROL_LIST) ? CONTROL_LIST_FILLED : BULK_LIST_FILLED,
+           1
+           );
+}
+
+/**
+
+  Account a finished transfer in the latency histogram of its list.
+
+  @param  Ohc                   UHC private data
+  @param  ListType              Pipe type
+  @param  StartTick             Performance counter value at submission
+
+**/
+STATIC
+VOID
+OhciRecordTransferLatency (
+  IN USB_OHCI_HC_DEV       *Ohc,
+  IN DESCRIPTOR_LIST_TYPE  ListType,
+  IN UINT64                StartTick
+  )
+{
+  UINT64  ElapsedUs;
+  UINTN   Bucket;
+
+  ElapsedUs = DivU64x32 (
+                GetTimeInNanoSecond (GetPerformanceCounter () - StartTick),
+                1000
+                );
+
+  for (Bucket = 0; Bucket < OHCI_LATENCY_BUCKETS - 1; Bucket++) {
+    if (ElapsedUs < LShiftU64 (OHCI_LATENCY_BUCKET_BASE, Bucket)) {
+      break;
+    }
+  }
+
+  Ohc->Latency[ListType].Count[Bucket]++;
+}
+
+/**
+
+  Wait for a transfer queued on a control or bulk ED to complete.
+
+  @param  Ohc                   UHC private data
+  @param  ListType              Pipe type
+  @param  Ed                    Endpoint ED
+  @param  HeadTd                First TD of the transfer
+  @param  TimeOut               Time to wait, in milliseconds
+  @param  EdResult              Result of the transfer
+
+  @retval EFI_SUCCESS           Transfer done
+  @retval EFI_NOT_READY         Transfer timed out
+  @retval EFI_DEVICE_ERROR      Transfer failed
+
+**/
+EFI_STATUS
+OhciWaitForAsyncTransfer (
+  IN  USB_OHCI_HC_DEV       *Ohc,
+  IN  DESCRIPTOR_LIST_TYPE  ListType,
+  IN  ED_DESCRIPTOR         *Ed,
+  IN  TD_DESCRIPTOR         *HeadTd,
+  IN  UINTN                 TimeOut,
+  OUT OHCI_ED_RESULT        *EdResult
+  )
+{
+  EFI_STATUS  Status;
+  UINT64      StartTick;
+  UINTN       Index;
+  UINTN       Retries;
+
+  StartTick = GetPerformanceCounter ();
+  Retries   = (TimeOut + 1) * (ONE_MILLI_SEC / OHCI_ASYNC_POLL_INTERVAL);
+
+  Status = CheckIfDone (Ohc, ListType, Ed, HeadTd, EdResult);
+  for (Index = 0; Status == EFI_NOT_READY && Index < Retries; Index++) {
+    gBS->Stall (OHCI_ASYNC_POLL_INTERVAL);
+    Status = CheckIfDone (Ohc, ListType, Ed, HeadTd, EdResult);
+  }
+
+  if (Status == EFI_NOT_READY) {
+    Ohc->Latency[ListType].Timeouts++;
+  } else {
+    OhciRecordTransferLatency (Ohc, ListType, StartTick);
+  }
+
+  return Status;
+}
+
+/**
+
+  Take back the TDs of a finished or timed out transfer from an endpoint
+  ED, leaving the ED idle on its list.
+
+  @param  Ohc                   UHC private data
+  @param  Ed                    Endpoint ED
+
+**/
+VOID
+OhciRetireAsyncTransfer (
+  IN USB_OHCI_HC_DEV  *Ohc,
+  IN ED_DESCRIPTOR    *Ed
+  )
+{
+  BOOLEAN  Active;
+
+  Active = (OhciGetEDField (Ed, ED_HALTED) == 0) &&
+           (OhciGetEDField (Ed, ED_TDHEAD_PTR) != OhciGetEDField (Ed, ED_TDTAIL_PTR));
+
+  OhciSetEDField (Ed, ED_SKIP, 1);
+  MemoryFence ();
+
+  if (Active) {
+    //
+    // The HC may still be working on one of the TDs. It honours the skip
+    // bit from the next frame on, so wait for that before taking the TDs
+    // back.
+    //
+    if (EFI_ERROR (OhciWaitForNextFrame (Ohc))) {
+      DEBUG ((DEBUG_ERROR, "OhciRetireAsyncTransfer: no SOF while cancelling transfer\r\n"));
+    }
+  }
+
+  OhciResetAsyncEd (Ed);
+}
+
 /**
 
   Convert TD condition code to Efi Status
@@ -400,34 +769,34 @@ OhciInvokeInterruptCallBack (
   }
 }
 
+//
+// Controllers with a registered interrupt, looked up by interrupt source
+// since the handler gets no context.
+//
+STATIC EFI_HARDWARE_INTERRUPT_PROTOCOL  *mOhciInterrupt;
+STATIC USB_OHCI_HC_DEV                  *mOhciInterruptControllers[OHCI_MAX_INTERRUPT_CONTROLLERS];
+
 /**
 
-  Timer to submit periodic interrupt transfer, and invoke callbacks hooked on done TDs
+  Submit periodic interrupt transfer again, and invoke callbacks hooked on done TDs
 
-  @param  Event                 Event handle
-  @param  Context               Device private data
+  @param  Ohc                   UHC private data
 
 **/
+STATIC
 VOID
-EFIAPI
-OhciHouseKeeper (
-  IN  EFI_EVENT  Event,
-  IN  VOID       *Context
+OhciServiceInterruptContexts (
+  IN USB_OHCI_HC_DEV  *Ohc
   )
 {
-  USB_OHCI_HC_DEV          *Ohc;
   INTERRUPT_CONTEXT_ENTRY  *Entry;
   INTERRUPT_CONTEXT_ENTRY  *PreEntry;
   ED_DESCRIPTOR            *Ed;
   TD_DESCRIPTOR            *DataTd;
   TD_DESCRIPTOR            *HeadTd;
 
-  UINT8    Toggle;
-  EFI_TPL  OriginalTPL;
-  UINT32   Result;
-
-  Ohc         = (USB_OHCI_HC_DEV *)Context;
-  OriginalTPL = gBS->RaiseTPL (TPL_NOTIFY);
+  UINT8   Toggle;
+  UINT32  Result;
 
   Entry    = Ohc->InterruptContextList;
   PreEntry = NULL;
@@ -445,7 +814,6 @@ OhciHouseKeeper (
     if (Entry->CallBackFunction != NULL) {
       OhciInvokeInterruptCallBack (Entry, Result);
       if (Ohc->InterruptContextList == NULL) {
-        gBS->RestoreTPL (OriginalTPL);
         return;
       }
     }
@@ -530,13 +898,271 @@ OhciHouseKeeper (
       }
 
       OhciFreeInterruptContextEntry (Ohc, PreEntry);
-      gBS->RestoreTPL (OriginalTPL);
       return;
     }
 
     PreEntry = Entry;
     Entry    = Entry->NextEntry;
   }
+}
+
+/**
+
+  Timer to submit periodic interrupt transfer, and invoke callbacks hooked on done TDs
+
+  @param  Event                 Event handle
+  @param  Context               Device private data
+
+**/
+VOID
+EFIAPI
+OhciHouseKeeper (
+  IN  EFI_EVENT  Event,
+  IN  VOID       *Context
+  )
+{
+  USB_OHCI_HC_DEV  *Ohc;
+  EFI_TPL          OriginalTPL;
+
+  Ohc         = (USB_OHCI_HC_DEV *)Context;
+  OriginalTPL = gBS->RaiseTPL (TPL_NOTIFY);
+
+  OhciServiceInterruptContexts (Ohc);
 
   gBS->RestoreTPL (OriginalTPL);
 }
+
+/**
+
+  Acknowledge a done queue write-back and service the interrupt contexts
+  whose TDs have been retired.
+
+  @param  Event                 Event handle
+  @param  Context               Device private data
+
+**/
+VOID
+EFIAPI
+OhciDoneQueueHandler (
+  IN  EFI_EVENT  Event,
+  IN  VOID       *Context
+  )
+{
+  USB_OHCI_HC_DEV  *Ohc;
+  EFI_TPL          OriginalTPL;
+
+  Ohc         = (USB_OHCI_HC_DEV *)Context;
+  OriginalTPL = gBS->RaiseTPL (TPL_NOTIFY);
+
+  //
+  // The done queue is linked through the NextTD field of the retired TDs.
+  // Control and bulk TDs are recycled as soon as their transfer completes,
+  // and periodic TDs are re-armed by the housekeeping timer, both of which
+  // rewrite that field, so the queue can't be walked safely. Only use the
+  // write-back as a signal, and find the completed contexts from the
+  // condition codes of the TDs they still own.
+  //
+
+  //
+  // Hand the done head back to the controller and unmask the interrupt,
+  // which the interrupt handler masked.
+  //
+  Ohc->HccaMemoryBlock->HccaDoneHead = 0;
+  OhciClearInterruptStatus (Ohc, WRITEBACK_DONE_HEAD);
+  OhciSetInterruptControl (Ohc, TRUE, WRITEBACK_DONE_HEAD, 1);
+
+  OhciServiceInterruptContexts (Ohc);
+
+  gBS->RestoreTPL (OriginalTPL);
+}
+
+/**
+
+  Interrupt handler shared by the registered controllers. It only masks
+  the done queue interrupt and defers the processing to the done queue
+  event.
+
+  @param  Source                Source of the interrupt
+  @param  SystemContext         Pointer to the system context
+
+**/
+STATIC
+VOID
+EFIAPI
+OhciInterruptHandler (
+  IN HARDWARE_INTERRUPT_SOURCE  Source,
+  IN EFI_SYSTEM_CONTEXT         SystemContext
+  )
+{
+  USB_OHCI_HC_DEV  *Ohc;
+  UINTN            Index;
+
+  for (Index = 0; Index < OHCI_MAX_INTERRUPT_CONTROLLERS; Index++) {
+    Ohc = mOhciInterruptControllers[Index];
+    if ((Ohc == NULL) || (Ohc->InterruptSource != Source)) {
+      continue;
+    }
+
+    if ((OhciGetHcInterruptControl (Ohc, WRITEBACK_DONE_HEAD) != 0) &&
+        (OhciGetHcInterruptStatus (Ohc, WRITEBACK_DONE_HEAD) != 0))
+    {
+      OhciSetInterruptControl (Ohc, FALSE, WRITEBACK_DONE_HEAD, 1);
+      gBS->SignalEvent (Ohc->DoneQueueEvent);
+    }
+  }
+
+  mOhciInterrupt->EndOfInterrupt (mOhciInterrupt, Source);
+}
+
+/**
+
+  Hook the controller's interrupt so done queue write-backs are processed
+  as they happen.
+
+  @param  Ohc                   UHC private data
+
+  @retval EFI_SUCCESS           Interrupt registered
+  @retval EFI_UNSUPPORTED       The controller has no interrupt, or there is
+                                no interrupt controller protocol
+  @retval EFI_OUT_OF_RESOURCES  Too many controllers registered
+  @retval Others                Failed to register the interrupt
+
+**/
+EFI_STATUS
+OhciRegisterDoneInterrupt (
+  IN USB_OHCI_HC_DEV  *Ohc
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       Index;
+
+  if (Ohc->Protocol->Interrupt == 0) {
+    return EFI_UNSUPPORTED;
+  }
+
+  if (mOhciInterrupt == NULL) {
+    Status = gBS->LocateProtocol (
+                    &gHardwareInterruptProtocolGuid,
+                    NULL,
+                    (VOID **)&mOhciInterrupt
+                    );
+    if (EFI_ERROR (Status)) {
+      mOhciInterrupt = NULL;
+      return EFI_UNSUPPORTED;
+    }
+  }
+
+  for (Index = 0; Index < OHCI_MAX_INTERRUPT_CONTROLLERS; Index++) {
+    if (mOhciInterruptControllers[Index] == NULL) {
+      break;
+    }
+  }
+
+  if (Index == OHCI_MAX_INTERRUPT_CONTROLLERS) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Status = gBS->CreateEvent (
+                  EVT_NOTIFY_SIGNAL,
+                  TPL_NOTIFY,
+                  OhciDoneQueueHandler,
+                  Ohc,
+                  &Ohc->DoneQueueEvent
+                  );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Ohc->InterruptSource             = Ohc->Protocol->Interrupt;
+  mOhciInterruptControllers[Index] = Ohc;
+
+  Status = mOhciInterrupt->RegisterInterruptSource (
+                             mOhciInterrupt,
+                             Ohc->InterruptSource,
+                             OhciInterruptHandler
+                             );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "OhciRegisterDoneInterrupt: Failed to register interrupt %u: %r\r\n", (UINT32)Ohc->InterruptSource, Status));
+    mOhciInterruptControllers[Index] = NULL;
+    gBS->CloseEvent (Ohc->DoneQueueEvent);
+    Ohc->DoneQueueEvent = NULL;
+    return Status;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+
+  Unhook the controller's interrupt registered by OhciRegisterDoneInterrupt.
+
+  @param  Ohc                   UHC private data
+
+**/
+VOID
+OhciUnregisterDoneInterrupt (
+  IN USB_OHCI_HC_DEV  *Ohc
+  )
+{
+  UINTN  Index;
+
+  if (Ohc->DoneQueueEvent == NULL) {
+    return;
+  }
+
+  OhciDisableDoneInterrupt (Ohc);
+  mOhciInterrupt->RegisterInterruptSource (mOhciInterrupt, Ohc->InterruptSource, NULL);
+
+  for (Index = 0; Index < OHCI_MAX_INTERRUPT_CONTROLLERS; Index++) {
+    if (mOhciInterruptControllers[Index] == Ohc) {
+      mOhciInterruptControllers[Index] = NULL;
+    }
+  }
+
+  gBS->CloseEvent (Ohc->DoneQueueEvent);
+  Ohc->DoneQueueEvent = NULL;
+}
+
+/**
+
+  Enable the done queue interrupt in the controller and at the interrupt
+  controller, if it is registered.
+
+  @param  Ohc                   UHC private data
+
+**/
+VOID
+OhciEnableDoneInterrupt (
+  IN USB_OHCI_HC_DEV  *Ohc
+  )
+{
+  if (Ohc->DoneQueueEvent == NULL) {
+    return;
+  }
+
+  Ohc->HccaMemoryBlock->HccaDoneHead = 0;
+  OhciClearInterruptStatus (Ohc, WRITEBACK_DONE_HEAD);
+  OhciSetInterruptControl (Ohc, TRUE, WRITEBACK_DONE_HEAD | MASTER_INTERRUPT, 1);
+  mOhciInterrupt->EnableInterruptSource (mOhciInterrupt, Ohc->InterruptSource);
+}
+
+/**
+
+  Mask the done queue interrupt in the controller and at the interrupt
+  controller, without releasing anything.
+
+  @param  Ohc                   UHC private data
+
+**/
+VOID
+OhciDisableDoneInterrupt (
+  IN USB_OHCI_HC_DEV  *Ohc
+  )
+{
+  if (Ohc->DoneQueueEvent == NULL) {
+    return;
+  }
+
+  OhciSetInterruptControl (Ohc, FALSE, WRITEBACK_DONE_HEAD | MASTER_INTERRUPT, 1);
+  mOhciInterrupt->DisableInterruptSource (mOhciInterrupt, Ohc->InterruptSource);
+}
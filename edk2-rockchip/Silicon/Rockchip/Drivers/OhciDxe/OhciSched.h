@@ -16,6 +16,42 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define GRID_SIZE      16
 #define GRID_SHIFT     4
 
+//
+// Interval, in microseconds, at which synchronous transfers are polled
+// for completion.
+//
+#define OHCI_ASYNC_POLL_INTERVAL  10
+
+//
+// Maximum time, in microseconds, to wait for the next start of frame.
+//
+#define OHCI_SOF_TIMEOUT  (2 * ONE_MILLI_SEC)
+
+//
+// Transfer latency buckets: bucket 0 counts transfers that took less than
+// 125us, each next bucket doubles the limit, the last one counts the rest.
+//
+#define OHCI_LATENCY_BUCKETS      10
+#define OHCI_LATENCY_BUCKET_BASE  125
+
+//
+// Period, in 100ns units, of the housekeeping timer that services the
+// asynchronous interrupt transfers. When the controller's done queue
+// interrupt is wired up, the timer is only a fallback and runs slower.
+//
+#define OHCI_HOUSEKEEPER_INTERVAL           (10 * 1000 * 10)
+#define OHCI_HOUSEKEEPER_FALLBACK_INTERVAL  (100 * 1000 * 10)
+
+//
+// Maximum number of controllers that can have their interrupt registered.
+//
+#define OHCI_MAX_INTERRUPT_CONTROLLERS  4
+
+typedef struct {
+  UINT32    Count[OHCI_LATENCY_BUCKETS];
+  UINT32    Timeouts;
+} OHCI_LATENCY_HISTOGRAM;
+
 typedef struct _INTERRUPT_CONTEXT_ENTRY INTERRUPT_CONTEXT_ENTRY;
 
 struct _INTERRUPT_CONTEXT_ENTRY {
@@ -202,6 +238,122 @@ OhciInvokeInterruptCallBack (
   IN  UINT32                   Result
   );
 
+/**
+
+  Set up the persistent EDs at the head of the control and bulk lists.
+
+  @param  Ohc                   UHC private data
+
+  @retval EFI_SUCCESS           Lists initialized
+  @retval EFI_OUT_OF_RESOURCES  Failed to allocate the EDs
+
+**/
+EFI_STATUS
+OhciInitializeAsyncLists (
+  IN USB_OHCI_HC_DEV  *Ohc
+  );
+
+/**
+
+  Free the control and bulk lists, including the cached endpoint EDs.
+  The host controller must not be processing the lists.
+
+  @param  Ohc                   UHC private data
+
+**/
+VOID
+OhciFreeAsyncLists (
+  IN USB_OHCI_HC_DEV  *Ohc
+  );
+
+/**
+
+  Look up the ED of an endpoint on the control or bulk list, creating and
+  linking a new one on first use. The ED then stays on the list, so that
+  later transfers to the same endpoint reuse it.
+
+  @param  Ohc                   UHC private data
+  @param  ListType              Pipe type
+  @param  DeviceAddress         Device address of the endpoint
+  @param  EndPointNum           Endpoint number
+  @param  EdDir                 ED direction
+
+  @retval                       The endpoint ED, or NULL if out of resources
+
+**/
+ED_DESCRIPTOR *
+OhciGetAsyncEd (
+  IN USB_OHCI_HC_DEV       *Ohc,
+  IN DESCRIPTOR_LIST_TYPE  ListType,
+  IN UINT8                 DeviceAddress,
+  IN UINT8                 EndPointNum,
+  IN UINT8                 EdDir
+  );
+
+/**
+
+  Hand a TD list over to an endpoint ED on the control or bulk list.
+
+  @param  Ohc                   UHC private data
+  @param  ListType              Pipe type
+  @param  Ed                    Endpoint ED
+  @param  HeadTd                First TD of the transfer
+  @param  TailTd                Empty TD terminating the transfer
+
+  @retval EFI_SUCCESS           Transfer queued
+  @retval EFI_DEVICE_ERROR      Failed to notify the host controller
+
+**/
+EFI_STATUS
+OhciQueueAsyncTransfer (
+  IN USB_OHCI_HC_DEV       *Ohc,
+  IN DESCRIPTOR_LIST_TYPE  ListType,
+  IN ED_DESCRIPTOR         *Ed,
+  IN TD_DESCRIPTOR         *HeadTd,
+  IN TD_DESCRIPTOR         *TailTd
+  );
+
+/**
+
+  Wait for a transfer queued on a control or bulk ED to complete.
+
+  @param  Ohc                   UHC private data
+  @param  ListType              Pipe type
+  @param  Ed                    Endpoint ED
+  @param  HeadTd                First TD of the transfer
+  @param  TimeOut               Time to wait, in milliseconds
+  @param  EdResult              Result of the transfer
+
+  @retval EFI_SUCCESS           Transfer done
+  @retval EFI_NOT_READY         Transfer timed out
+  @retval EFI_DEVICE_ERROR      Transfer failed
+
+**/
+EFI_STATUS
+OhciWaitForAsyncTransfer (
+  IN  USB_OHCI_HC_DEV       *Ohc,
+  IN  DESCRIPTOR_LIST_TYPE  ListType,
+  IN  ED_DESCRIPTOR         *Ed,
+  IN  TD_DESCRIPTOR         *HeadTd,
+  IN  UINTN                 TimeOut,
+  OUT OHCI_ED_RESULT        *EdResult
+  );
+
+/**
+
+  Take back the TDs of a finished or timed out transfer from an endpoint
+  ED, leaving the ED idle on its list.
+
+  @param  Ohc                   UHC private data
+  @param  Ed                    Endpoint ED
+
+**/
+VOID
+OhciRetireAsyncTransfer (
+  IN USB_OHCI_HC_DEV  *Ohc,
+  IN ED_DESCRIPTOR    *Ed
+  );
+
 /**
 
   Timer to submit periodic interrupt transfer, and invoke callbacks hooked on done TDs
@@ -218,4 +370,77 @@ OhciHouseKeeper (
   IN  VOID       *Context
   );
 
+/**
+
+  Acknowledge a done queue write-back and service the interrupt contexts
+  whose TDs have been retired.
+
+  @param  Event                 Event handle
+  @param  Context               Device private data
+
+**/
+VOID
+EFIAPI
+OhciDoneQueueHandler (
+  IN  EFI_EVENT  Event,
+  IN  VOID       *Context
+  );
+
+/**
+
+  Hook the controller's interrupt so done queue write-backs are processed
+  as they happen.
+
+  @param  Ohc                   UHC private data
+
+  @retval EFI_SUCCESS           Interrupt registered
+  @retval EFI_UNSUPPORTED       The controller has no interrupt, or there is
+                                no interrupt controller protocol
+  @retval EFI_OUT_OF_RESOURCES  Too many controllers registered
+  @retval Others                Failed to register the interrupt
+
+**/
+EFI_STATUS
+OhciRegisterDoneInterrupt (
+  IN USB_OHCI_HC_DEV  *Ohc
+  );
+
+/**
+
+  Unhook the controller's interrupt registered by OhciRegisterDoneInterrupt.
+
+  @param  Ohc                   UHC private data
+
+**/
+VOID
+OhciUnregisterDoneInterrupt (
+  IN USB_OHCI_HC_DEV  *Ohc
+  );
+
+/**
+
+  Enable the done queue interrupt in the controller and at the interrupt
+  controller, if it is registered.
+
+  @param  Ohc                   UHC private data
+
+**/
+VOID
+OhciEnableDoneInterrupt (
+  IN USB_OHCI_HC_DEV  *Ohc
+  );
+
+/**
+
+  Mask the done queue interrupt in the controller and at the interrupt
+  controller, without releasing anything.
+
+  @param  Ohc                   UHC private data
+
+**/
+VOID
+OhciDisableDoneInterrupt (
+  IN USB_OHCI_HC_DEV  *Ohc
+  );
+
 #endif
@@ -26,6 +26,14 @@ OhciCreateTD (
 {
   TD_DESCRIPTOR  *Td;
 
+  if (Ohc->FreeTdList != NULL) {
+    Td              = Ohc->FreeTdList;
+    Ohc->FreeTdList = (TD_DESCRIPTOR *)(UINTN)Td->NextTDPointer;
+    Ohc->FreeTdCount--;
+    ZeroMem (Td, sizeof (TD_DESCRIPTOR));
+    return Td;
+  }
+
   Td = UsbHcAllocateMem (Ohc->MemPool, sizeof (TD_DESCRIPTOR));
   if (Td == NULL) {
     DEBUG ((DEBUG_INFO, "STV allocate TD fail !\r\n"));
@@ -60,11 +68,53 @@ OhciFreeTD (
     return EFI_SUCCESS;
   }
 
+  //
+  // TDs live in the pre-mapped pool, keep them around for the next
+  // transfer rather than handing them back.
+  //
+  if (Ohc->FreeTdCount < OHCI_TD_FREE_LIST_MAX) {
+    Td->NextTDPointer = (UINT32)(UINTN)Ohc->FreeTdList;
+    Ohc->FreeTdList   = Td;
+    Ohc->FreeTdCount++;
+    return EFI_SUCCESS;
+  }
+
   UsbHcFreeMem (Ohc->MemPool, Td, sizeof (TD_DESCRIPTOR));
 
   return EFI_SUCCESS;
 }
 
+/**
+
+  Pre-allocate TDs into the free list.
+
+  @Param  Ohc                   UHC private data
+  @Param  Count                 Number of TDs to add
+
+  @retval  EFI_SUCCESS          TDs added
+  @retval  EFI_OUT_OF_RESOURCES Failed to allocate the TDs
+
+**/
+EFI_STATUS
+OhciFillTDFreeList (
+  IN USB_OHCI_HC_DEV  *Ohc,
+  IN UINTN            Count
+  )
+{
+  TD_DESCRIPTOR  *Td;
+
+  while (Count-- > 0) {
+    Td = UsbHcAllocateMem (Ohc->MemPool, sizeof (TD_DESCRIPTOR));
+    if (Td == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    OhciFreeTD (Ohc, Td);
+  }
+
+  return EFI_SUCCESS;
+}
+
 /**
 
   Create a ED
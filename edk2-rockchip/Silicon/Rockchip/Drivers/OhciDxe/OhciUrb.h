@@ -12,6 +12,13 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include "Descriptor.h"
 
+//
+// Number of TDs set aside when the controller starts, and the most that are
+// kept around for reuse.
+//
+#define OHCI_TD_FREE_LIST_INITIAL  32
+#define OHCI_TD_FREE_LIST_MAX      256
+
 //
 // Func List
 //
@@ -30,6 +37,23 @@ OhciCreateTD (
   IN USB_OHCI_HC_DEV  *Ohc
   );
 
+/**
+
+  Pre-allocate TDs into the free list.
+
+  @Param  Ohc                   UHC private data
+  @Param  Count                 Number of TDs to add
+
+  @retval  EFI_SUCCESS          TDs added
+  @retval  EFI_OUT_OF_RESOURCES Failed to allocate the TDs
+
+**/
+EFI_STATUS
+OhciFillTDFreeList (
+  IN USB_OHCI_HC_DEV  *Ohc,
+  IN UINTN            Count
+  );
+
 /**
 
   Free a TD
@@ -0,0 +1,369 @@
+/** @file
+  Host based unit tests of the OHCI memory pool in UsbHcMem.c.
+
+  Copyright (c) 2026, Rockchip Limited. All rights reserved.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UnitTestLib.h>
+
+#include "../UsbHcMem.h"
+
+#define UNIT_TEST_NAME     "OHCI UsbHcMem Unit Tests"
+#define UNIT_TEST_VERSION  "1.0"
+
+//
+// Number of allocation units in a default sized block.
+//
+#define DEFAULT_BLOCK_UNITS  (EFI_PAGES_TO_SIZE (USBHC_MEM_DEFAULT_PAGES) / USBHC_MEM_UNIT)
+
+STATIC USBHC_MEM_POOL  *mPool;
+STATIC UINT8           *mUnits[DEFAULT_BLOCK_UNITS];
+
+/**
+  Count the blocks currently linked into the pool.
+**/
+STATIC
+UINTN
+CountBlocks (
+  IN USBHC_MEM_POOL  *Pool
+  )
+{
+  USBHC_MEM_BLOCK  *Block;
+  UINTN            Count;
+
+  Count = 0;
+  for (Block = Pool->Head; Block != NULL; Block = Block->Next) {
+    Count++;
+  }
+
+  return Count;
+}
+
+/**
+  Fill the head block with single unit allocations, recording them in
+  mUnits in address order.
+**/
+STATIC
+UNIT_TEST_STATUS
+FillHeadBlock (
+  VOID
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < DEFAULT_BLOCK_UNITS; Index++) {
+    mUnits[Index] = UsbHcAllocateMem (mPool, USBHC_MEM_UNIT);
+    UT_ASSERT_NOT_NULL (mUnits[Index]);
+    UT_ASSERT_TRUE (mUnits[Index] == mPool->Head->BufHost + Index * USBHC_MEM_UNIT);
+  }
+
+  UT_ASSERT_EQUAL (mPool->Head->UsedUnits, DEFAULT_BLOCK_UNITS);
+  UT_ASSERT_EQUAL (CountBlocks (mPool), 1);
+
+  return UNIT_TEST_PASSED;
+}
+
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+PoolSetup (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  mPool = UsbHcInitMemPool (FALSE, 0);
+  if (mPool == NULL) {
+    return UNIT_TEST_ERROR_PREREQUISITE_NOT_MET;
+  }
+
+  ZeroMem (mUnits, sizeof (mUnits));
+  return UNIT_TEST_PASSED;
+}
+
+STATIC
+VOID
+EFIAPI
+PoolCleanup (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UsbHcFreeMemPool (mPool);
+  mPool = NULL;
+}
+
+/**
+  Allocations are unit aligned, zeroed, accounted for and released again.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+AllocFreeAccounting (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT8  *Small;
+  UINT8  *Odd;
+  UINT8  *Large;
+
+  Small = UsbHcAllocateMem (mPool, 16);
+  Odd   = UsbHcAllocateMem (mPool, USBHC_MEM_UNIT + 1);
+  Large = UsbHcAllocateMem (mPool, 4 * USBHC_MEM_UNIT);
+  UT_ASSERT_NOT_NULL (Small);
+  UT_ASSERT_NOT_NULL (Odd);
+  UT_ASSERT_NOT_NULL (Large);
+
+  UT_ASSERT_EQUAL ((UINTN)Small & USBHC_MEM_UNIT_MASK, 0);
+  UT_ASSERT_EQUAL ((UINTN)Odd & USBHC_MEM_UNIT_MASK, 0);
+  UT_ASSERT_EQUAL ((UINTN)Large & USBHC_MEM_UNIT_MASK, 0);
+
+  //
+  // 1 + 2 + 4 units, handed out first fit from the start of the block.
+  //
+  UT_ASSERT_EQUAL (mPool->Head->UsedUnits, 7);
+  UT_ASSERT_TRUE (Small == mPool->Head->BufHost);
+  UT_ASSERT_TRUE (Odd == Small + USBHC_MEM_UNIT);
+  UT_ASSERT_TRUE (Large == Odd + 2 * USBHC_MEM_UNIT);
+
+  UT_ASSERT_TRUE (IsZeroBuffer (Large, 4 * USBHC_MEM_UNIT));
+  SetMem (Large, 4 * USBHC_MEM_UNIT, 0xA5);
+
+  UsbHcFreeMem (mPool, Odd, USBHC_MEM_UNIT + 1);
+  UT_ASSERT_EQUAL (mPool->Head->UsedUnits, 5);
+
+  //
+  // A freed region is reused and handed out zeroed again.
+  //
+  UsbHcFreeMem (mPool, Large, 4 * USBHC_MEM_UNIT);
+  Large = UsbHcAllocateMem (mPool, 5 * USBHC_MEM_UNIT);
+  UT_ASSERT_TRUE (Large == Small + USBHC_MEM_UNIT);
+  UT_ASSERT_TRUE (IsZeroBuffer (Large, 5 * USBHC_MEM_UNIT));
+
+  UsbHcFreeMem (mPool, Large, 5 * USBHC_MEM_UNIT);
+  UsbHcFreeMem (mPool, Small, 16);
+  UT_ASSERT_EQUAL (mPool->Head->UsedUnits, 0);
+  UT_ASSERT_TRUE (IsZeroBuffer (mPool->Head->Bits, mPool->Head->BitsLen * sizeof (UINT64)));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Multi unit requests only land in holes large enough for them, including
+  holes that straddle a bitmap word boundary.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+Fragmentation (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UNIT_TEST_STATUS  Status;
+  UINTN             Index;
+  UINT8             *Mem;
+
+  Status = FillHeadBlock ();
+  if (Status != UNIT_TEST_PASSED) {
+    return Status;
+  }
+
+  //
+  // Leave single unit holes across the whole block.
+  //
+  for (Index = 0; Index < DEFAULT_BLOCK_UNITS; Index += 2) {
+    UsbHcFreeMem (mPool, mUnits[Index], USBHC_MEM_UNIT);
+    mUnits[Index] = NULL;
+  }
+
+  UT_ASSERT_EQUAL (mPool->Head->UsedUnits, DEFAULT_BLOCK_UNITS / 2);
+
+  //
+  // Four units straddling the first word boundary, then three more in
+  // the middle of the next word.
+  //
+  for (Index = 61; Index < 67; Index += 2) {
+    UsbHcFreeMem (mPool, mUnits[Index], USBHC_MEM_UNIT);
+    mUnits[Index] = NULL;
+  }
+
+  for (Index = 99; Index < 102; Index += 2) {
+    UsbHcFreeMem (mPool, mUnits[Index], USBHC_MEM_UNIT);
+    mUnits[Index] = NULL;
+  }
+
+  Mem = UsbHcAllocateMem (mPool, 7 * USBHC_MEM_UNIT);
+  UT_ASSERT_TRUE (Mem == mPool->Head->BufHost + 60 * USBHC_MEM_UNIT);
+
+  Mem = UsbHcAllocateMem (mPool, 5 * USBHC_MEM_UNIT);
+  UT_ASSERT_TRUE (Mem == mPool->Head->BufHost + 98 * USBHC_MEM_UNIT);
+
+  //
+  // Only single unit holes are left, so a two unit request must grow the
+  // pool while a single unit request still fits the head block.
+  //
+  Mem = UsbHcAllocateMem (mPool, 2 * USBHC_MEM_UNIT);
+  UT_ASSERT_NOT_NULL (Mem);
+  UT_ASSERT_EQUAL (CountBlocks (mPool), 2);
+  UT_ASSERT_TRUE (Mem == mPool->Head->Next->BufHost);
+
+  UsbHcFreeMem (mPool, Mem, 2 * USBHC_MEM_UNIT);
+  UT_ASSERT_EQUAL (CountBlocks (mPool), 1);
+
+  Mem = UsbHcAllocateMem (mPool, USBHC_MEM_UNIT);
+  UT_ASSERT_TRUE (Mem == mPool->Head->BufHost);
+  UT_ASSERT_EQUAL (CountBlocks (mPool), 1);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  The pool grows by default sized blocks, or by a block large enough for
+  an oversized request, and empty blocks other than the head are freed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+PoolGrowth (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UNIT_TEST_STATUS  Status;
+  UINT8             *Grown;
+  UINT8             *Huge;
+  UINTN             HugeSize;
+
+  Status = FillHeadBlock ();
+  if (Status != UNIT_TEST_PASSED) {
+    return Status;
+  }
+
+  Grown = UsbHcAllocateMem (mPool, USBHC_MEM_UNIT);
+  UT_ASSERT_NOT_NULL (Grown);
+  UT_ASSERT_EQUAL (CountBlocks (mPool), 2);
+  UT_ASSERT_EQUAL (mPool->Head->Next->BufLen, EFI_PAGES_TO_SIZE (USBHC_MEM_DEFAULT_PAGES));
+
+  HugeSize = EFI_PAGES_TO_SIZE (USBHC_MEM_DEFAULT_PAGES) + 100;
+  Huge     = UsbHcAllocateMem (mPool, HugeSize);
+  UT_ASSERT_NOT_NULL (Huge);
+  UT_ASSERT_EQUAL (CountBlocks (mPool), 3);
+
+  //
+  // New blocks are linked right behind the head.
+  //
+  UT_ASSERT_TRUE (Huge == mPool->Head->Next->BufHost);
+  UT_ASSERT_EQUAL (mPool->Head->Next->BufLen, EFI_PAGES_TO_SIZE (EFI_SIZE_TO_PAGES (HugeSize) + 1));
+  UT_ASSERT_TRUE (UsbHcIsMemInPool (mPool, Huge, HugeSize));
+
+  UsbHcFreeMem (mPool, Huge, HugeSize);
+  UT_ASSERT_EQUAL (CountBlocks (mPool), 2);
+  UT_ASSERT_FALSE (UsbHcIsMemInPool (mPool, Huge, HugeSize));
+
+  //
+  // The head block is never released, even when it becomes empty.
+  //
+  UsbHcFreeMem (mPool, mUnits[0], USBHC_MEM_UNIT);
+  UsbHcFreeMem (mPool, Grown, USBHC_MEM_UNIT);
+  UT_ASSERT_EQUAL (CountBlocks (mPool), 1);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  UsbHcIsMemInPool() only accepts regions fully inside one block.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+MemInPool (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  USBHC_MEM_BLOCK  *Head;
+  UINT8            *Mem;
+  UINT8            Local[USBHC_MEM_UNIT];
+
+  Head = mPool->Head;
+  Mem  = UsbHcAllocateMem (mPool, USBHC_MEM_UNIT);
+  UT_ASSERT_NOT_NULL (Mem);
+
+  UT_ASSERT_TRUE (UsbHcIsMemInPool (mPool, Mem, USBHC_MEM_UNIT));
+  UT_ASSERT_TRUE (UsbHcIsMemInPool (mPool, Head->BufHost, Head->BufLen));
+  UT_ASSERT_TRUE (UsbHcIsMemInPool (mPool, Head->BufHost + Head->BufLen - 1, 1));
+
+  UT_ASSERT_FALSE (UsbHcIsMemInPool (mPool, Head->BufHost, Head->BufLen + 1));
+  UT_ASSERT_FALSE (UsbHcIsMemInPool (mPool, Head->BufHost + Head->BufLen, 1));
+  UT_ASSERT_FALSE (UsbHcIsMemInPool (mPool, Local, sizeof (Local)));
+
+  UsbHcFreeMem (mPool, Mem, USBHC_MEM_UNIT);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests and run them.
+
+  @retval EFI_SUCCESS           All test cases were dispatched.
+  @retval EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                initialize the unit tests.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      PoolTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&PoolTests, Framework, "UsbHcMem Pool Tests", "OhciDxe.UsbHcMem", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for UsbHcMem Pool Tests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  AddTestCase (PoolTests, "Allocations are aligned, zeroed and accounted for", "AllocFree", AllocFreeAccounting, PoolSetup, PoolCleanup, NULL);
+  AddTestCase (PoolTests, "Requests only use holes large enough for them", "Fragmentation", Fragmentation, PoolSetup, PoolCleanup, NULL);
+  AddTestCase (PoolTests, "The pool grows and shrinks by whole blocks", "Growth", PoolGrowth, PoolSetup, PoolCleanup, NULL);
+  AddTestCase (PoolTests, "Only regions inside one block are in the pool", "MemInPool", MemInPool, PoolSetup, PoolCleanup, NULL);
+
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework != NULL) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return UnitTestingEntry ();
+}
@@ -9,6 +9,83 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include "Ohci.h"
 
+/**
+  Return the index of the lowest set bit of a non-zero 64-bit value.
+
+  @param  Operand        The value to scan, must not be zero.
+
+  @return The index of the lowest set bit.
+
+**/
+STATIC
+UINTN
+UsbHcCountTrailingZeros (
+  IN UINT64  Operand
+  )
+{
+  ASSERT (Operand != 0);
+
+ #if defined (__GNUC__) || defined (__clang__)
+  return (UINTN)__builtin_ctzll (Operand);
+ #else
+  return (UINTN)LowBitSet64 (Operand);
+ #endif
+}
+
+/**
+  Mark a run of units in a block as allocated or free.
+
+  @param  Block          The memory block.
+  @param  Start          The first unit of the run.
+  @param  Units          Number of units in the run.
+  @param  Allocated      TRUE to mark the units allocated, FALSE to free them.
+
+**/
+STATIC
+VOID
+UsbHcMarkUnits (
+  IN USBHC_MEM_BLOCK  *Block,
+  IN UINTN            Start,
+  IN UINTN            Units,
+  IN BOOLEAN          Allocated
+  )
+{
+  UINTN   Index;
+  UINTN   Shift;
+  UINTN   Run;
+  UINT64  Mask;
+
+  if (Allocated) {
+    Block->UsedUnits += Units;
+  } else {
+    ASSERT (Block->UsedUnits >= Units);
+    Block->UsedUnits -= Units;
+  }
+
+  while (Units > 0) {
+    Index = Start / USBHC_MEM_BITS_PER_WORD;
+    Shift = Start % USBHC_MEM_BITS_PER_WORD;
+    Run   = MIN (Units, USBHC_MEM_BITS_PER_WORD - Shift);
+
+    if (Run == USBHC_MEM_BITS_PER_WORD) {
+      Mask = MAX_UINT64;
+    } else {
+      Mask = LShiftU64 (LShiftU64 (1, Run) - 1, Shift);
+    }
+
+    if (Allocated) {
+      ASSERT ((Block->Bits[Index] & Mask) == 0);
+      Block->Bits[Index] |= Mask;
+    } else {
+      ASSERT ((Block->Bits[Index] & Mask) == Mask);
+      Block->Bits[Index] &= ~Mask;
+    }
+
+    Start += Run;
+    Units -= Run;
+  }
+}
+
 /**
   Allocate a block of memory to be used by the buffer pool.
 
@@ -40,11 +117,11 @@ UsbHcAllocMemBlock (
   // each bit in the bit array represents USBHC_MEM_UNIT
   // bytes of memory in the memory block.
   //
-  ASSERT (USBHC_MEM_UNIT * 8 <= EFI_PAGE_SIZE);
+  ASSERT (EFI_PAGE_SIZE % (USBHC_MEM_UNIT * USBHC_MEM_BITS_PER_WORD) == 0);
 
   Block->BufLen  = EFI_PAGES_TO_SIZE (Pages);
-  Block->BitsLen = Block->BufLen / (USBHC_MEM_UNIT * 8);
-  Block->Bits    = AllocateZeroPool (Block->BitsLen);
+  Block->BitsLen = Block->BufLen / (USBHC_MEM_UNIT * USBHC_MEM_BITS_PER_WORD);
+  Block->Bits    = AllocateZeroPool (Block->BitsLen * sizeof (UINT64));
 
   if (Block->Bits == NULL) {
     gBS->FreePool (Block);
@@ -143,60 +220,62 @@ UsbHcAllocMemFromBlock (
   IN  UINTN            Units
   )
 {
-  UINTN  Byte;
-  UINT8  Bit;
-  UINTN  StartByte;
-  UINT8  StartBit;
-  UINTN  Available;
-  UINTN  Count;
+  UINTN   TotalUnits;
+  UINTN   Start;
+  UINTN   End;
+  UINTN   Index;
+  UINT64  Word;
 
   ASSERT ((Block != 0) && (Units != 0));
 
-  StartByte = 0;
-  StartBit  = 0;
-  Available = 0;
-
-  for (Byte = 0, Bit = 0; Byte < Block->BitsLen;) {
-    //
-    // If current bit is zero, the corresponding memory unit is
-    // available, otherwise we need to restart our searching.
-    // Available counts the consective number of zero bit.
-    //
-    if (!USB_HC_BIT_IS_SET (Block->Bits[Byte], Bit)) {
-      Available++;
+  TotalUnits = Block->BitsLen * USBHC_MEM_BITS_PER_WORD;
+  if (Block->UsedUnits + Units > TotalUnits) {
+    return NULL;
+  }
 
-      if (Available >= Units) {
-        break;
+  //
+  // Find the runs of free units a word at a time: skip to the next clear
+  // bit, then to the next set bit, and check whether the run in between
+  // is long enough.
+  //
+  Start = 0;
+  while (Start + Units <= TotalUnits) {
+    Index = Start / USBHC_MEM_BITS_PER_WORD;
+    Word  = ~Block->Bits[Index] & LShiftU64 (MAX_UINT64, Start % USBHC_MEM_BITS_PER_WORD);
+    while (Word == 0) {
+      if (++Index >= Block->BitsLen) {
+        return NULL;
       }
 
-      NEXT_BIT (Byte, Bit);
-    } else {
-      NEXT_BIT (Byte, Bit);
+      Word = ~Block->Bits[Index];
+    }
 
-      Available = 0;
-      StartByte = Byte;
-      StartBit  = Bit;
+    Start = Index * USBHC_MEM_BITS_PER_WORD + UsbHcCountTrailingZeros (Word);
+    if (Start + Units > TotalUnits) {
+      return NULL;
     }
-  }
 
-  if (Available < Units) {
-    return NULL;
-  }
+    Index = Start / USBHC_MEM_BITS_PER_WORD;
+    Word  = Block->Bits[Index] & LShiftU64 (MAX_UINT64, Start % USBHC_MEM_BITS_PER_WORD);
+    while ((Word == 0) && (++Index < Block->BitsLen)) {
+      Word = Block->Bits[Index];
+    }
 
-  //
-  // Mark the memory as allocated
-  //
-  Byte = StartByte;
-  Bit  = StartBit;
+    if (Word == 0) {
+      End = TotalUnits;
+    } else {
+      End = Index * USBHC_MEM_BITS_PER_WORD + UsbHcCountTrailingZeros (Word);
+    }
 
-  for (Count = 0; Count < Units; Count++) {
-    ASSERT (!USB_HC_BIT_IS_SET (Block->Bits[Byte], Bit));
+    if (End - Start >= Units) {
+      UsbHcMarkUnits (Block, Start, Units, TRUE);
+      return Block->BufHost + Start * USBHC_MEM_UNIT;
+    }
 
-    Block->Bits[Byte] = (UINT8)(Block->Bits[Byte] | USB_HC_BIT (Bit));
-    NEXT_BIT (Byte, Bit);
+    Start = End;
   }
 
-  return Block->BufHost + (StartByte * 8 + StartBit) * USBHC_MEM_UNIT;
+  return NULL;
 }
 
 /**
@@ -279,15 +358,7 @@ UsbHcIsMemBlockEmpty (
   IN USBHC_MEM_BLOCK  *Block
   )
 {
-  UINTN  Index;
-
-  for (Index = 0; Index < Block->BitsLen; Index++) {
-    if (Block->Bits[Index] != 0) {
-      return FALSE;
-    }
-  }
-
-  return TRUE;
+  return Block->UsedUnits == 0;
 }
 
 /**
@@ -335,7 +406,7 @@ UsbHcInitMemPool (
 {
   USBHC_MEM_POOL  *Pool;
 
-  Pool = AllocatePool (sizeof (USBHC_MEM_POOL));
+  Pool = AllocateZeroPool (sizeof (USBHC_MEM_POOL));
 
   if (Pool == NULL) {
     return Pool;
@@ -481,9 +552,6 @@ UsbHcFreeMem (
   USBHC_MEM_BLOCK  *Block;
   UINT8            *ToFree;
   UINTN            AllocSize;
-  UINTN            Byte;
-  UINTN            Bit;
-  UINTN            Count;
 
   Head      = Pool->Head;
   AllocSize = USBHC_MEM_ROUND (Size);
@@ -495,22 +563,15 @@ UsbHcFreeMem (
     // completely contains the memory to free.
     //
     if ((Block->BufHost <= ToFree) && ((ToFree + AllocSize) <= (Block->BufHost + Block->BufLen))) {
-      //
-      // compute the start byte and bit in the bit array
-      //
-      Byte = ((ToFree - Block->BufHost) / USBHC_MEM_UNIT) / 8;
-      Bit  = ((ToFree - Block->BufHost) / USBHC_MEM_UNIT) % 8;
-
       //
       // reset associated bits in bit arry
       //
-      for (Count = 0; Count < (AllocSize / USBHC_MEM_UNIT); Count++) {
-        ASSERT (USB_HC_BIT_IS_SET (Block->Bits[Byte], Bit));
-
-        Block->Bits[Byte] = (UINT8)(Block->Bits[Byte] ^ USB_HC_BIT (Bit));
-        NEXT_BIT (Byte, Bit);
-      }
-
+      UsbHcMarkUnits (
+        Block,
+        (ToFree - Block->BufHost) / USBHC_MEM_UNIT,
+        AllocSize / USBHC_MEM_UNIT,
+        FALSE
+        );
       break;
     }
   }
@@ -532,3 +593,35 @@ UsbHcFreeMem (
 
   return;
 }
+
+/**
+  Check whether a region of memory lies within one of the pool's blocks.
+
+  @param  Pool  The memory pool of the host controller.
+  @param  Mem   The start of the region.
+  @param  Size  The size of the region.
+
+  @retval TRUE  The region is inside the pool.
+  @retval FALSE The region is not inside the pool.
+
+**/
+BOOLEAN
+UsbHcIsMemInPool (
+  IN USBHC_MEM_POOL  *Pool,
+  IN VOID            *Mem,
+  IN UINTN           Size
+  )
+{
+  USBHC_MEM_BLOCK  *Block;
+  UINT8            *Start;
+
+  Start = (UINT8 *)Mem;
+
+  for (Block = Pool->Head; Block != NULL; Block = Block->Next) {
+    if ((Block->BufHost <= Start) && ((Start + Size) <= (Block->BufHost + Block->BufLen))) {
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
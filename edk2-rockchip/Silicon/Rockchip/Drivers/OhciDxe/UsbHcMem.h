@@ -11,18 +11,14 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #ifndef _USB_HC_MEM_H_
 #define _USB_HC_MEM_H_
 
-#define USB_HC_BIT(a)  ((UINTN)(1 << (a)))
-
-#define USB_HC_BIT_IS_SET(Data, Bit)   \
-          ((BOOLEAN)(((Data) & USB_HC_BIT(Bit)) == USB_HC_BIT(Bit)))
-
 #define USB_HC_HIGH_32BIT(Addr64)    \
           ((UINT32)(RShiftU64((UINTN)(Addr64), 32) & 0XFFFFFFFF))
 
 typedef struct _USBHC_MEM_BLOCK USBHC_MEM_BLOCK;
 struct _USBHC_MEM_BLOCK {
-  UINT8              *Bits;         // Bit array to record which unit is allocated
-  UINTN              BitsLen;
+  UINT64             *Bits;         // Bit array to record which unit is allocated
+  UINTN              BitsLen;       // Number of 64-bit words in Bits
+  UINTN              UsedUnits;     // Number of units allocated
   UINT8              *Buf;
   UINT8              *BufHost;
   UINTN              BufLen;        // Memory size in bytes
@@ -52,16 +48,9 @@ typedef struct _USBHC_MEM_POOL {
 #define USBHC_MEM_ROUND(Len)  (((Len) + USBHC_MEM_UNIT_MASK) & (~USBHC_MEM_UNIT_MASK))
 
 //
-// Advance the byte and bit to the next bit, adjust byte accordingly.
+// Number of units tracked by each word of the block bitmap.
 //
-#define NEXT_BIT(Byte, Bit)   \
-          do {                \
-            (Bit)++;          \
-            if ((Bit) > 7) {  \
-              (Byte)++;       \
-              (Bit) = 0;      \
-            }                 \
-          } while (0)
+#define USBHC_MEM_BITS_PER_WORD  64
 
 /**
   Initialize the memory management pool for the host controller.
@@ -126,6 +115,24 @@ UsbHcFreeMem (
   IN UINTN           Size
   );
 
+/**
+  Check whether a region of memory lies within one of the pool's blocks.
+
+  @param  Pool  The memory pool of the host controller.
+  @param  Mem   The start of the region.
+  @param  Size  The size of the region.
+
+  @retval TRUE  The region is inside the pool.
+  @retval FALSE The region is not inside the pool.
+
+**/
+BOOLEAN
+UsbHcIsMemInPool (
+  IN USBHC_MEM_POOL  *Pool,
+  IN VOID            *Mem,
+  IN UINTN           Size
+  );
+
 /**
   Calculate the corresponding address according to the Mem parameter.
 
@@ -55,7 +55,9 @@ STATIC CONST FVB_DEVICE  mRkFvbFlashInstanceTemplate = {
 
   NULL,  // DiskDevice ... NEED TO BE FILLED
   0,     // DiskMediaId ... NEED TO BE FILLED
-  FALSE, // DiskDataInvalidated ... NEED TO BE FILLED
+  NULL,  // DiskDirtyBitmap ... NEED TO BE FILLED
+  0,     // DiskDirtyBlockCount ... NEED TO BE FILLED
+  0,     // DiskBytesWritten
 
   NULL, // Handle ... NEED TO BE FILLED
 
@@ -114,6 +116,44 @@ STATIC CONST FVB_DEVICE  mRkFvbFlashInstanceTemplate = {
   } // DevicePath
 };
 
+/**
+  Marks the blocks covering a byte range of the FV as needing to be
+  synced to the boot disk.
+
+  @param[in]  FlashInstance - The FVB device
+  @param[in]  Offset        - Byte offset relative to the start of the FV
+  @param[in]  Length        - Number of bytes modified
+
+**/
+STATIC
+VOID
+FvbMarkDiskDataDirty (
+  IN FVB_DEVICE  *FlashInstance,
+  IN UINTN       Offset,
+  IN UINTN       Length
+  )
+{
+  UINTN  Block;
+  UINTN  LastBlock;
+
+  if ((FlashInstance->DiskDirtyBitmap == NULL) || (Length == 0) ||
+      (Offset >= FlashInstance->FvbSize))
+  {
+    return;
+  }
+
+  if (Length > FlashInstance->FvbSize - Offset) {
+    Length = FlashInstance->FvbSize - Offset;
+  }
+
+  Block     = Offset / FlashInstance->Media.BlockSize;
+  LastBlock = (Offset + Length - 1) / FlashInstance->Media.BlockSize;
+
+  for ( ; Block <= LastBlock; Block++) {
+    FVB_DIRTY_BIT_SET (FlashInstance->DiskDirtyBitmap, Block);
+  }
+}
+
 //
 // The Firmware Volume Block Protocol is the low-level interface
 // to a firmware volume. File-level access to a firmware volume
@@ -778,7 +818,11 @@ FvbWrite (
   CopyMem ((UINTN *)DataOffset, Buffer, *NumBytes);
 
   // Must sync the data if it's on a disk
-  FlashInstance->DiskDataInvalidated = TRUE;
+  FvbMarkDiskDataDirty (
+    FlashInstance,
+    GET_DATA_OFFSET (Offset, Lba, FlashInstance->Media.BlockSize),
+    *NumBytes
+    );
 
   return EFI_SUCCESS;
 }
@@ -947,7 +991,11 @@ FvbEraseBlocks (
       SetMem ((UINTN *)BlockAddress, FlashInstance->Media.BlockSize, 0xFF);
 
       // Must sync the data if it's on a disk
-      FlashInstance->DiskDataInvalidated = TRUE;
+      FvbMarkDiskDataDirty (
+        FlashInstance,
+        GET_DATA_OFFSET (0, StartingLba, FlashInstance->Media.BlockSize),
+        FlashInstance->Media.BlockSize
+        );
 
       // Move to the next Lba
       StartingLba++;
@@ -979,6 +1027,11 @@ FvbVirtualNotifyEvent (
   // Convert SPI memory mapped region
   EfiConvertPointer (0x0, (VOID **)&mFvbDevice->RegionBaseAddress);
 
+  // Convert disk dirty tracking
+  if (mFvbDevice->DiskDirtyBitmap != NULL) {
+    EfiConvertPointer (0x0, (VOID **)&mFvbDevice->DiskDirtyBitmap);
+  }
+
   // Convert SPI device description
   // EfiConvertPointer (0x0, (VOID**)&mFvbDevice->SpiDevice.Info);
   // EfiConvertPointer (0x0, (VOID**)&mFvbDevice->SpiDevice.HostRegisterBaseAddress);
@@ -1126,6 +1179,20 @@ FvbConfigureFlashInstance (
     }
   }
 
+  if (!FlashInstance->IsSpiFlashAvailable) {
+    //
+    // Track which blocks get modified, so that only those need to be
+    // written back when the NV data is dumped on the boot device.
+    //
+    FlashInstance->DiskDirtyBlockCount = FlashInstance->FvbSize / FlashInstance->Media.BlockSize;
+    FlashInstance->DiskDirtyBitmap     = AllocateRuntimeZeroPool (
+                                           FVB_DIRTY_BITMAP_SIZE (FlashInstance->DiskDirtyBlockCount)
+                                           );
+    if (FlashInstance->DiskDirtyBitmap == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+  }
+
   Status = gBS->InstallMultipleProtocolInterfaces (
                   &FlashInstance->Handle,
                   &gEfiDevicePathProtocolGuid,
@@ -1135,7 +1202,7 @@ FvbConfigureFlashInstance (
                   NULL
                   );
   if (EFI_ERROR (Status)) {
-    return Status;
+    goto Exit;
   }
 
   Status = FvbPrepareFvHeader (FlashInstance);
@@ -1148,9 +1215,27 @@ FvbConfigureFlashInstance (
            );
   }
 
+Exit:
+  if (EFI_ERROR (Status) && (FlashInstance->DiskDirtyBitmap != NULL)) {
+    FreePool (FlashInstance->DiskDirtyBitmap);
+    FlashInstance->DiskDirtyBitmap = NULL;
+  }
+
   return Status;
 }
 
+/**
+  Writes the blocks of the FV that were modified since the last dump
+  to the boot disk. Adjacent dirty blocks are coalesced into a single
+  DiskIo request.
+
+  @param[in]  Device   - Device path of the boot disk
+  @param[in]  MediaId  - Media ID of the boot disk
+
+  @retval  EFI_SUCCESS - All dirty blocks were written.
+  @retval  Others      - The disk could not be located or written.
+
+**/
 STATIC
 EFI_STATUS
 FvbDiskDumpNvData (
@@ -1161,7 +1246,13 @@ FvbDiskDumpNvData (
   EFI_STATUS            Status;
   EFI_DISK_IO_PROTOCOL  *DiskIo = NULL;
   EFI_HANDLE            Handle;
-  UINTN                 DataOffset;
+  UINTN                 DiskOffset;
+  UINTN                 MemOffset;
+  UINTN                 BlockSize;
+  UINTN                 Block;
+  UINTN                 RunStart;
+  UINTN                 RunSize;
+  UINT64                BytesWritten;
 
   Status = gBS->LocateDevicePath (&gEfiDiskIoProtocolGuid, &Device, &Handle);
   if (EFI_ERROR (Status)) {
@@ -1173,21 +1264,92 @@ FvbDiskDumpNvData (
     return Status;
   }
 
-  DataOffset = GET_DATA_OFFSET (
+  BlockSize = mFvbDevice->Media.BlockSize;
+
+  DiskOffset = GET_DATA_OFFSET (
                  mFvbDevice->FvbOffset,
                  mFvbDevice->StartLba,
-                 mFvbDevice->Media.BlockSize
+                 BlockSize
                  );
+  MemOffset = GET_DATA_OFFSET (
+                mFvbDevice->RegionBaseAddress,
+                mFvbDevice->StartLba,
+                BlockSize
+                );
+
+  BytesWritten = 0;
+  Block        = 0;
+
+  while (Block < mFvbDevice->DiskDirtyBlockCount) {
+    if (!FVB_DIRTY_BIT_TEST (mFvbDevice->DiskDirtyBitmap, Block)) {
+      Block++;
+      continue;
+    }
 
-  Status = DiskIo->WriteDisk (
-                     DiskIo,
-                     MediaId,
-                     DataOffset,
-                     mFvbDevice->FvbSize,
-                     (VOID *)mFvbDevice->FvbOffset
-                     );
+    RunStart = Block;
+    while ((Block < mFvbDevice->DiskDirtyBlockCount) &&
+           FVB_DIRTY_BIT_TEST (mFvbDevice->DiskDirtyBitmap, Block))
+    {
+      Block++;
+    }
 
-  return Status;
+    RunSize = (Block - RunStart) * BlockSize;
+
+    Status = DiskIo->WriteDisk (
+                       DiskIo,
+                       MediaId,
+                       DiskOffset + RunStart * BlockSize,
+                       RunSize,
+                       (VOID *)(MemOffset + RunStart * BlockSize)
+                       );
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    BytesWritten += RunSize;
+  }
+
+  ZeroMem (
+    mFvbDevice->DiskDirtyBitmap,
+    FVB_DIRTY_BITMAP_SIZE (mFvbDevice->DiskDirtyBlockCount)
+    );
+
+  mFvbDevice->DiskBytesWritten += BytesWritten;
+
+  DEBUG ((
+    DEBUG_INFO,
+    "%a: Wrote %lu of %lu bytes (%lu total)\n",
+    __FUNCTION__,
+    BytesWritten,
+    (UINT64)mFvbDevice->FvbSize,
+    mFvbDevice->DiskBytesWritten
+    ));
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Checks whether any block of the FV needs to be synced to the boot disk.
+
+  @retval  TRUE  - At least one block is dirty.
+  @retval  FALSE - The disk copy is up to date.
+
+**/
+STATIC
+BOOLEAN
+FvbIsDiskDataDirty (
+  VOID
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < FVB_DIRTY_BITMAP_SIZE (mFvbDevice->DiskDirtyBlockCount); Index++) {
+    if (mFvbDevice->DiskDirtyBitmap[Index] != 0) {
+      return TRUE;
+    }
+  }
+
+  return FALSE;
 }
 
 STATIC
@@ -1203,7 +1365,7 @@ FvbDiskNvDumpHandler (
     return;
   }
 
-  if (!mFvbDevice->DiskDataInvalidated) {
+  if (!FvbIsDiskDataDirty ()) {
     return;
   }
 
@@ -1225,8 +1387,6 @@ FvbDiskNvDumpHandler (
   }
 
   DEBUG ((DEBUG_INFO, "NV data dumped!\n"));
-
-  mFvbDevice->DiskDataInvalidated = FALSE;
 }
 
 STATIC
@@ -1480,6 +1640,19 @@ FvbProcessBootDiskDeviceHandle (
     goto Exit;
   }
 
+  //
+  // The shadow copy was loaded from the device we booted from, so only the
+  // blocks modified since then need to be written back. If the NV data came
+  // from somewhere else, the entire FV must be synced.
+  //
+  if (mBootDeviceType != BootDevice->AtagBootDevType) {
+    SetMem (
+      mFvbDevice->DiskDirtyBitmap,
+      FVB_DIRTY_BITMAP_SIZE (mFvbDevice->DiskDirtyBlockCount),
+      0xFF
+      );
+  }
+
   Status = FvbDiskDumpNvData (Device, BlkIo->Media->MediaId);
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_ERROR, "%a: [%s] Couldn't update NV data!\n", __FUNCTION__, DevicePathText));
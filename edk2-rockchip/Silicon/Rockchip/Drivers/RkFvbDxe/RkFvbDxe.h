@@ -18,6 +18,10 @@
 
 #define GET_DATA_OFFSET(BaseAddr, Lba, LbaSize)  ((BaseAddr) + (UINTN)((Lba) * (LbaSize)))
 
+#define FVB_DIRTY_BITMAP_SIZE(Blocks)  (((Blocks) + 7) / 8)
+#define FVB_DIRTY_BIT_SET(Map, Bit)    ((Map)[(Bit) / 8] |= (UINT8)(1 << ((Bit) % 8)))
+#define FVB_DIRTY_BIT_TEST(Map, Bit)   (((Map)[(Bit) / 8] & (1 << ((Bit) % 8))) != 0)
+
 #define FVB_FLASH_SIGNATURE  SIGNATURE_32('S', 'n', 'o', 'r')
 #define INSTANCE_FROM_FVB_THIS(a)  CR(a, FVB_DEVICE, FvbProtocol, FVB_FLASH_SIGNATURE)
 
@@ -47,7 +51,9 @@ typedef struct {
 
   EFI_DEVICE_PATH_PROTOCOL               *DiskDevice;
   UINT32                                 DiskMediaId;
-  BOOLEAN                                DiskDataInvalidated;
+  UINT8                                  *DiskDirtyBitmap;
+  UINTN                                  DiskDirtyBlockCount;
+  UINT64                                 DiskBytesWritten;
 
   EFI_HANDLE                             Handle;
 
@@ -132,9 +132,30 @@ RkSdmmcCardDetect (
   return PresenceState == RkSdmmcCardPresent;
 }
 
+STATIC
+EFI_STATUS
+EFIAPI
+RkSdmmcSetPhase (
+  IN EFI_HANDLE               Controller,
+  IN UINT8                    Slot,
+  IN DW_MMC_CLOCK_PHASE_TYPE  Type,
+  IN UINT32                   Degrees
+  )
+{
+  if (Controller != mDwMmcCapability.Controller) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  return RkSdmmcSetClockPhase (
+           (Type == DwMmcSamplePhase) ? RkSdmmcSamplePhase : RkSdmmcDrivePhase,
+           Degrees
+           );
+}
+
 STATIC PLATFORM_DW_MMC_PROTOCOL  mDwMmcDeviceProtocol = {
   RkSdmmcGetCapability,
-  RkSdmmcCardDetect
+  RkSdmmcCardDetect,
+  RkSdmmcSetPhase
 };
 
 EFI_STATUS
@@ -17,28 +17,149 @@
 #include <Library/MemoryAllocationLib.h>
 #include <Library/BaseMemoryLib.h>
 #include <Library/DevicePathLib.h>
+#include <Library/PcdLib.h>
+#include <Library/UefiLib.h>
 
+#include <Guid/BootDiscoveryPolicy.h>
 #include <Protocol/OhciDeviceProtocol.h>
 
 #include "UsbHcd.h"
 
+STATIC VOID  *mPlatformConfigAppliedRegistration;
+
+/**
+  Look up the per-controller value of a UINT32 array PCD.
+
+  @param  Array        Pointer to the PCD data.
+  @param  ArraySize    Size of the PCD data in bytes.
+  @param  Index        Index of the controller.
+  @param  Value        The value for the controller, if present.
+
+  @retval TRUE         The PCD has a value for this controller.
+  @retval FALSE        The PCD is too short, the default should be used.
+
+**/
+STATIC
+BOOLEAN
+UsbHcdGetControllerSetting (
+  IN  UINT8   *Array,
+  IN  UINTN   ArraySize,
+  IN  UINTN   Index,
+  OUT UINT32  *Value
+  )
+{
+  if ((ArraySize % sizeof (UINT32) != 0) ||
+      ((Index + 1) * sizeof (UINT32) > ArraySize))
+  {
+    return FALSE;
+  }
+
+  *Value = ReadUnaligned32 ((UINT32 *)(Array + Index * sizeof (UINT32)));
+  return TRUE;
+}
+
+STATIC
+UINTN
+XhciGetControllerIndex (
+  IN  UINTN  UsbReg
+  )
+{
+  UINT8  *XhciControllerAddrArrayPtr;
+  UINTN  XhciControllerAddrArraySize;
+  UINTN  Index;
+
+  XhciControllerAddrArrayPtr  = PcdGetPtr (PcdDwc3BaseAddresses);
+  XhciControllerAddrArraySize = PcdGetSize (PcdDwc3BaseAddresses) / sizeof (UINT32);
+
+  for (Index = 0; Index < XhciControllerAddrArraySize; Index++) {
+    if (ReadUnaligned32 ((UINT32 *)(XhciControllerAddrArrayPtr + Index * sizeof (UINT32))) == UsbReg) {
+      break;
+    }
+  }
+
+  return Index;
+}
+
 STATIC
 VOID
 XhciSetBeatBurstLength (
-  IN  UINTN  UsbReg
+  IN  UINTN  UsbReg,
+  IN  UINTN  Index
   )
 {
-  DWC3  *Dwc3Reg;
+  DWC3    *Dwc3Reg;
+  UINT32  BurstTypes;
+  UINT32  PipeTransLimit;
 
   Dwc3Reg = (VOID *)(UsbReg + DWC3_REG_OFFSET);
 
+  if (!UsbHcdGetControllerSetting (
+         PcdGetPtr (PcdDwc3AxiBurstTypes),
+         PcdGetSize (PcdDwc3AxiBurstTypes),
+         Index,
+         &BurstTypes
+         ))
+  {
+    BurstTypes = USB3_ENABLE_BEAT_BURST;
+  }
+
+  if (!UsbHcdGetControllerSetting (
+         PcdGetPtr (PcdDwc3PipeTransLimits),
+         PcdGetSize (PcdDwc3PipeTransLimits),
+         Index,
+         &PipeTransLimit
+         ))
+  {
+    PipeTransLimit = DWC3_GSBUSCFG1_PIPETRANSLIMIT_DEFAULT;
+  }
+
   MmioAndThenOr32 (
     (UINTN)&Dwc3Reg->GSBusCfg0,
     ~USB3_ENABLE_BEAT_BURST_MASK,
-    USB3_ENABLE_BEAT_BURST
+    BurstTypes & USB3_ENABLE_BEAT_BURST_MASK
     );
 
-  MmioOr32 ((UINTN)&Dwc3Reg->GSBusCfg1, USB3_SET_BEAT_BURST_LIMIT);
+  MmioAndThenOr32 (
+    (UINTN)&Dwc3Reg->GSBusCfg1,
+    ~DWC3_GSBUSCFG1_PIPETRANSLIMIT_MASK,
+    DWC3_GSBUSCFG1_PIPETRANSLIMIT (PipeTransLimit)
+    );
+}
+
+STATIC
+VOID
+XhciSetThresholds (
+  IN  UINTN  UsbReg,
+  IN  UINTN  Index
+  )
+{
+  DWC3    *Dwc3Reg;
+  UINT32  Value;
+
+  Dwc3Reg = (VOID *)(UsbReg + DWC3_REG_OFFSET);
+
+  //
+  // Thresholding is left as configured by the core unless asked for.
+  //
+  if (UsbHcdGetControllerSetting (
+        PcdGetPtr (PcdDwc3RxThresholds),
+        PcdGetSize (PcdDwc3RxThresholds),
+        Index,
+        &Value
+        ))
+  {
+    MmioWrite32 ((UINTN)&Dwc3Reg->GRxThrCfg, Value);
+  }
+
+  if (UsbHcdGetControllerSetting (
+        PcdGetPtr (PcdDwc3TxThresholds),
+        PcdGetSize (PcdDwc3TxThresholds),
+        Index,
+        &Value
+        ))
+  {
+    MmioWrite32 ((UINTN)&Dwc3Reg->GTxThrCfg, Value);
+  }
 }
 
 STATIC
@@ -224,6 +345,7 @@ InitializeXhciController (
 {
   EFI_STATUS            Status;
   EFI_PHYSICAL_ADDRESS  UsbReg = This->Resources->AddrRangeMin;
+  UINTN                 Index;
 
   DEBUG ((DEBUG_INFO, "XHCI: Initialize DWC3 at 0x%lX\n", UsbReg));
 
@@ -239,10 +361,23 @@ InitializeXhciController (
     return EFI_DEVICE_ERROR;
   }
 
+  Index = XhciGetControllerIndex (UsbReg);
+
   //
   // Change beat burst and outstanding pipelined transfers requests
   //
-  XhciSetBeatBurstLength (UsbReg);
+  XhciSetBeatBurstLength (UsbReg, Index);
+
+  XhciSetThresholds (UsbReg, Index);
+
+  DEBUG ((
+    DEBUG_INFO,
+    "XHCI: GSBUSCFG0=0x%X GSBUSCFG1=0x%X GRXTHRCFG=0x%X GTXTHRCFG=0x%X\n",
+    MmioRead32 (UsbReg + DWC3_REG_OFFSET + OFFSET_OF (DWC3, GSBusCfg0)),
+    MmioRead32 (UsbReg + DWC3_REG_OFFSET + OFFSET_OF (DWC3, GSBusCfg1)),
+    MmioRead32 (UsbReg + DWC3_REG_OFFSET + OFFSET_OF (DWC3, GRxThrCfg)),
+    MmioRead32 (UsbReg + DWC3_REG_OFFSET + OFFSET_OF (DWC3, GTxThrCfg))
+    ));
 
   return EFI_SUCCESS;
 }
@@ -259,7 +394,8 @@ STATIC
 EFI_STATUS
 EFIAPI
 RegisterOhciController (
-  IN UINT32  BaseAddress
+  IN UINT32  BaseAddress,
+  IN UINT32  Interrupt
   )
 {
   EFI_STATUS            Status;
@@ -273,6 +409,7 @@ RegisterOhciController (
   }
 
   OhciDevice->BaseAddress = BaseAddress;
+  OhciDevice->Interrupt   = Interrupt;
 
   OhciDevicePath = (OHCI_DEVICE_PATH *)CreateDeviceNode (
                                          HARDWARE_DEVICE_PATH,
@@ -319,17 +456,45 @@ FreeOhciDevice:
 }
 
 /**
-  This function gets registered as a callback to perform USB controller intialization
+  Get the mask of controllers that must not be registered.
 
-  @param  Event         Event whose notification function is being invoked.
-  @param  Context       Pointer to the notification function's context.
+  Bits 0-7 select XHCI controllers, in PcdDwc3BaseAddresses order.
+  Bits 8-15 select EHCI/OHCI controller pairs.
+
+  @return The mask of controllers to skip.
 
 **/
+STATIC
+UINT32
+UsbGetSkipMask (
+  VOID
+  )
+{
+  UINT32  SkipMask;
+
+  SkipMask = PcdGet32 (PcdUsbMinimalBootSkipMask);
+  if (SkipMask == 0) {
+    return 0;
+  }
+
+  //
+  // Only skip controllers if the boot policy doesn't connect all devices.
+  //
+  if (PcdGet32 (PcdBootDiscoveryPolicy) != BDP_CONNECT_MINIMAL) {
+    return 0;
+  }
+
+  return SkipMask;
+}
+
+/**
+  Power up the USB ports and register the USB controllers.
+
+**/
+STATIC
 VOID
-EFIAPI
-UsbEndOfDxeCallback (
-  IN EFI_EVENT  Event,
-  IN VOID       *Context
+UsbRegisterControllers (
+  VOID
   )
 {
   EFI_STATUS  Status;
@@ -339,9 +504,12 @@ UsbEndOfDxeCallback (
   UINT32      XhciControllerAddr;
   UINT32      EhciControllerAddr;
   UINT32      OhciControllerAddr;
+  UINT8       *OhciInterruptArrayPtr;
+  UINTN       OhciInterruptArraySize;
+  UINT32      OhciInterrupt;
   UINT32      Index;
-
-  gBS->CloseEvent (Event);
+  UINT32      SkipMask;
+  UINT32      AllMask;
 
   XhciControllerAddrArrayPtr  = PcdGetPtr (PcdDwc3BaseAddresses);
   XhciControllerAddrArraySize = PcdGetSize (PcdDwc3BaseAddresses);
@@ -353,6 +521,17 @@ UsbEndOfDxeCallback (
 
   NumUsb2Controller = PcdGet32 (PcdNumEhciController);
 
+  OhciInterruptArrayPtr  = PcdGetPtr (PcdOhciInterrupts);
+  OhciInterruptArraySize = PcdGetSize (PcdOhciInterrupts);
+
+  SkipMask = UsbGetSkipMask ();
+  AllMask  = (UINT32)((1 << (XhciControllerAddrArraySize / sizeof (UINT32))) - 1) |
+             (UINT32)(((1 << NumUsb2Controller) - 1) << 8);
+  if ((SkipMask & AllMask) == AllMask) {
+    DEBUG ((DEBUG_INFO, "USB: All controllers skipped by boot policy\n"));
+    return;
+  }
+
   /* Enable USB PHYs */
   Usb2PhyResume ();
 
@@ -360,6 +539,11 @@ UsbEndOfDxeCallback (
 
   /* Register USB3 controllers */
   for (Index = 0; Index < XhciControllerAddrArraySize; Index += sizeof (UINT32)) {
+    if ((SkipMask & (1 << (Index / sizeof (UINT32)))) != 0) {
+      DEBUG ((DEBUG_INFO, "USB: Skipping XHCI controller %u\n", Index / sizeof (UINT32)));
+      continue;
+    }
+
     XhciControllerAddr = XhciControllerAddrArrayPtr[Index] |
                          XhciControllerAddrArrayPtr[Index + 1] << 8 |
                          XhciControllerAddrArrayPtr[Index + 2] << 16 |
@@ -387,6 +571,11 @@ UsbEndOfDxeCallback (
 
   /* Register USB2 controllers */
   for (Index = 0; Index < NumUsb2Controller; Index++) {
+    if ((SkipMask & (1 << (Index + 8))) != 0) {
+      DEBUG ((DEBUG_INFO, "USB: Skipping EHCI/OHCI controller %u\n", Index));
+      continue;
+    }
+
     EhciControllerAddr = PcdGet32 (PcdEhciBaseAddress) +
                          (Index * (PcdGet32 (PcdEhciSize) + PcdGet32 (PcdOhciSize)));
     OhciControllerAddr = EhciControllerAddr + PcdGet32 (PcdOhciSize);
@@ -410,7 +599,13 @@ UsbEndOfDxeCallback (
         ));
     }
 
-    Status = RegisterOhciController (OhciControllerAddr);
+    /* OHCI falls back to polling if it has no interrupt */
+    OhciInterrupt = 0;
+    if ((Index + 1) * sizeof (UINT32) <= OhciInterruptArraySize) {
+      OhciInterrupt = ReadUnaligned32 ((UINT32 *)(OhciInterruptArrayPtr + Index * sizeof (UINT32)));
+    }
+
+    Status = RegisterOhciController (OhciControllerAddr, OhciInterrupt);
 
     if (EFI_ERROR (Status)) {
       DEBUG ((
@@ -423,6 +618,58 @@ UsbEndOfDxeCallback (
   }
 }
 
+/**
+  This function gets registered as a callback to perform USB controller intialization
+
+  @param  Event         Event whose notification function is being invoked.
+  @param  Context       Pointer to the notification function's context.
+
+**/
+VOID
+EFIAPI
+UsbEndOfDxeCallback (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  gBS->CloseEvent (Event);
+
+  UsbRegisterControllers ();
+}
+
+/**
+  This function gets registered as a callback to perform USB controller
+  intialization as soon as the platform configuration has been applied.
+
+  @param  Event         Event whose notification function is being invoked.
+  @param  Context       Pointer to the notification function's context.
+
+**/
+STATIC
+VOID
+EFIAPI
+UsbPlatformConfigAppliedCallback (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  EFI_STATUS  Status;
+  VOID        *Interface;
+
+  Status = gBS->LocateProtocol (
+                  &gRockchipPlatformConfigAppliedProtocolGuid,
+                  NULL,
+                  &Interface
+                  );
+  if (EFI_ERROR (Status)) {
+    return;
+  }
+
+  gBS->CloseEvent (Event);
+
+  UsbRegisterControllers ();
+}
+
 /**
   The Entry Point of module. It follows the standard UEFI driver model.
 
@@ -442,6 +689,30 @@ InitializeUsbHcd (
 {
   EFI_STATUS  Status;
   EFI_EVENT   EndOfDxeEvent;
+  EFI_EVENT   PlatformConfigAppliedEvent;
+
+  //
+  // Move the PHY resume, port power enable and controller registration
+  // from EndOfDxe to the point where the platform config is applied. They
+  // still run synchronously in that notification, including any delay the
+  // platform's UsbPortPowerEnable () has. What is gained is that VBUS has
+  // been on for the rest of DXE by the time BDS connects the controllers,
+  // so devices that are slow to come up are more likely to be ready.
+  //
+  if (FixedPcdGetBool (PcdUsbEarlyRegistration)) {
+    PlatformConfigAppliedEvent = EfiCreateProtocolNotifyEvent (
+                                   &gRockchipPlatformConfigAppliedProtocolGuid,
+                                   TPL_CALLBACK,
+                                   UsbPlatformConfigAppliedCallback,
+                                   NULL,
+                                   &mPlatformConfigAppliedRegistration
+                                   );
+    if (PlatformConfigAppliedEvent == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    return EFI_SUCCESS;
+  }
 
   Status = gBS->CreateEventEx (
                   EVT_NOTIFY_SIGNAL,
@@ -60,6 +60,19 @@
 #define USB3_ENABLE_BEAT_BURST_MASK  0xFF
 #define USB3_SET_BEAT_BURST_LIMIT    0xF00
 
+/* Global SoC Bus Configuration Register 1 */
+#define DWC3_GSBUSCFG1_PIPETRANSLIMIT(N)  (((N) & 0xf) << 8)
+#define DWC3_GSBUSCFG1_PIPETRANSLIMIT_MASK  DWC3_GSBUSCFG1_PIPETRANSLIMIT(0xf)
+#define DWC3_GSBUSCFG1_PIPETRANSLIMIT_DEFAULT  0xF
+
+/* Global RX/TX Threshold Control Registers */
+#define DWC3_GRXTHRCFG_PKTCNTSEL  BIT29
+#define DWC3_GRXTHRCFG_PKTCNT(N)  (((N) & 0xf) << 24)
+#define DWC3_GRXTHRCFG_MAXRXBURSTSIZE(N)  (((N) & 0x1f) << 19)
+#define DWC3_GTXTHRCFG_PKTCNTSEL  BIT29
+#define DWC3_GTXTHRCFG_PKTCNT(N)  (((N) & 0xf) << 24)
+#define DWC3_GTXTHRCFG_MAXTXBURSTSIZE(N)  (((N) & 0xff) << 16)
+
 /* DCFG Register */
 #define DCFG_SPEED_MASK     (BIT2|BIT1|BIT0)
 #define DCFG_SPEED_HS       0
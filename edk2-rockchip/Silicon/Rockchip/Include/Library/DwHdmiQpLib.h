@@ -71,6 +71,7 @@
 #define I2CM_CONTROL0                0xec
 #define I2CM_STATUS0                 0xf0
 #define I2CM_INTERFACE_CONTROL0      0xf4
+#define I2CM_NBYTES                  0xf00000
 #define I2CM_ADDR                    0xff000
 #define I2CM_SLVADDR                 0xfe0
 #define I2CM_WR_MASK                 0x1e
@@ -920,6 +921,8 @@ struct DwHdmiQpI2c {
   UINT8      SlaveReg;
   BOOLEAN    IsSegment;
   BOOLEAN    IsRegAddr;
+  BOOLEAN    BlockRead;
+  BOOLEAN    BlockReadSupported;
 };
 
 struct DwHdmiQpDevice {
@@ -1004,4 +1007,9 @@ HdptxRopllCmnConfig (
   IN  UINT32                       BitRate
   );
 
+VOID
+HdptxPowerOff (
+  OUT struct RockchipHdptxPhyHdmi  *Hdptx
+  );
+
 #endif
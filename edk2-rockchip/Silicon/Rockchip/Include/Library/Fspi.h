@@ -70,6 +70,13 @@ struct HAL_FSPI_XMMC_DEV {
   UINT32           writeCmd;
 };
 
+/** FSPI data transfer mode */
+#define FSPI_XFER_MODE_PIO  (0)
+#define FSPI_XFER_MODE_DMA  (1)
+
+/** Smallest data phase worth moving by DMA */
+#define FSPI_DMA_MIN_SIZE  (64)
+
 /** XIP may be not accessble, so place it in sram or psram */
 struct HAL_FSPI_HOST {
   struct FSPI_REG    *instance;
@@ -77,6 +84,12 @@ struct HAL_FSPI_HOST {
   UINT8              cs;   /**< Should be defined by user in each operation */
   UINT8              mode; /**< Should be defined by user, referring to hal_spi_mem.h */
   UINT8              cell; /**< Record DLL cell for PM resume, Set depend on corresponding device */
+  UINT8              xferMode;      /**< Mode used by the last data transfer */
+  void               *dmaBuffer;    /**< DMA bounce buffer, PIO only if NULL */
+  UINT32             dmaBufferAddr; /**< Device address of dmaBuffer, must be 32-bit */
+  UINT32             dmaBufferSize;
+  UINT64             pioBytes; /**< Bytes moved through the FIFO */
+  UINT64             dmaBytes; /**< Bytes moved by DMA */
 };
 
 #define HAL_FSPI_MAX_DELAY_LINE_CELLS  (0xFFU)
@@ -14,6 +14,11 @@ typedef enum {
   RkSdmmcCardNotPresent
 } RKSDMMC_CARD_PRESENCE_STATE;
 
+typedef enum {
+  RkSdmmcDrivePhase = 0,
+  RkSdmmcSamplePhase
+} RKSDMMC_CLOCK_PHASE_TYPE;
+
 EFI_STATUS
 EFIAPI
 RkSdmmcSetClockRate (
@@ -31,3 +36,10 @@ EFIAPI
 RkSdmmcGetCardPresenceState (
   VOID
   );
+
+EFI_STATUS
+EFIAPI
+RkSdmmcSetClockPhase (
+  IN RKSDMMC_CLOCK_PHASE_TYPE  Type,
+  IN UINT32                    Degrees
+  );
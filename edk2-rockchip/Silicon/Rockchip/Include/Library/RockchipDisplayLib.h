@@ -293,6 +293,11 @@ GetVopOutputIfName (
   IN UINT32  OutputInterface
   );
 
+BOOLEAN
+IsEdidBlockChecksumValid (
+  IN UINT8  *EdidBlock
+  );
+
 EFI_STATUS
 CheckEdidBlock (
   IN UINT8  *EdidBlock,
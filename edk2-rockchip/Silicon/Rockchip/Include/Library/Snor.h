@@ -72,6 +72,7 @@ struct SPI_NOR {
   UINT8                      addrWidth;
   UINT8                      eraseOpcodeSec;
   UINT8                      eraseOpcodeBlk;
+  UINT8                      eraseOpcodeBlk32;
   UINT8                      readOpcode;
   UINT8                      readDummy;
   UINT8                      programOpcode;
@@ -87,6 +88,7 @@ struct SPI_NOR {
 
 typedef enum {
   ERASE_SECTOR = 0,
+  ERASE_BLOCK32K,
   ERASE_BLOCK64K,
   ERASE_CHIP
 } NOR_ERASE_TYPE;
@@ -159,6 +161,14 @@ HAL_SNOR_Erase (
   NOR_ERASE_TYPE  EraseType
   );
 
+NOR_ERASE_TYPE
+HAL_SNOR_PlanErase (
+  struct SPI_NOR  *nor,
+  UINT32          addr,
+  UINT32          len,
+  UINT32          *eraseSize
+  );
+
 BOOLEAN
 HAL_SNOR_IsFlashSupported (
   UINT8  *flashId
@@ -16,6 +16,7 @@
 
 typedef struct {
   UINT32    BaseAddress;
+  UINT32    Interrupt;      // GIC interrupt ID, 0 if not available
 } OHCI_DEVICE_PROTOCOL;
 
 extern EFI_GUID  gOhciDeviceProtocolGuid;
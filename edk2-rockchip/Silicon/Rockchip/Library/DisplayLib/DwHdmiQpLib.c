@@ -14,6 +14,9 @@
 #include <Library/TimerLib.h>
 #include <Library/BaseLib.h>
 #include <Library/MemoryAllocationLib.h>
+#include <Library/PcdLib.h>
+#include <Library/PrintLib.h>
+#include <Library/UefiRuntimeServicesTableLib.h>
 #include <Library/DwHdmiQpLib.h>
 #include <Library/DrmModes.h>
 #include <Library/RockchipPlatformLib.h>
@@ -22,6 +25,8 @@
 
 #include <Protocol/RockchipConnectorProtocol.h>
 
+#include <Guid/HdmiEdidCache.h>
+
 #include <VarStoreData.h>
 
 #define HIWORD_UPDATE(val, mask)  (val | (mask) << 16)
@@ -89,6 +94,21 @@
 
 #define HDMI_EDID_BLOCK_RETRIES  4
 
+//
+// DDC runs at 100 kHz, so a byte takes about 90 us on the wire. Poll the
+// transfer status with a short, growing delay rather than in 1 ms steps.
+//
+#define HDMI_I2C_BYTE_TIME_US     90
+#define HDMI_I2C_POLL_MIN_US      5
+#define HDMI_I2C_POLL_MAX_US      100
+#define HDMI_I2C_TIMEOUT_US       (20 * 1000)
+#define HDMI_I2C_BLOCK_READ_SIZE  16
+
+//
+// Header, manufacturer, product code and serial number of the base block.
+//
+#define HDMI_EDID_ID_SIZE  18
+
 /* DW-HDMI Controller >= 0x200a are at least compliant with SCDC version 1 */
 #define SCDC_MIN_SOURCE_VERSION  0x1
 
@@ -191,6 +211,42 @@ DwHdmiReadHpd (
   }
 }
 
+STATIC
+UINT32
+DwHdmiI2cWaitForInterrupt (
+  IN struct DwHdmiQpDevice  *Hdmi,
+  IN UINTN                  Count
+  )
+{
+  UINT64  Deadline;
+  UINTN   Delay;
+  UINT32  Intr;
+
+  Deadline = GetTimeInNanoSecond (GetPerformanceCounter ()) + HDMI_I2C_TIMEOUT_US * 1000ULL;
+
+  //
+  // Nothing can complete before the bytes are on the wire.
+  //
+  MicroSecondDelay (Count * HDMI_I2C_BYTE_TIME_US);
+
+  for (Delay = HDMI_I2C_POLL_MIN_US; ; Delay = MIN (Delay * 2, HDMI_I2C_POLL_MAX_US)) {
+    Intr  = DwHdmiQpRegRead (Hdmi, MAINUNIT_1_INT_STATUS);
+    Intr &= (I2CM_OP_DONE_IRQ |
+             I2CM_READ_REQUEST_IRQ |
+             I2CM_NACK_RCVD_IRQ);
+    if (Intr) {
+      DwHdmiQpRegWrite (Hdmi, Intr, MAINUNIT_1_INT_CLEAR);
+      return Intr;
+    }
+
+    if (GetTimeInNanoSecond (GetPerformanceCounter ()) > Deadline) {
+      return 0;
+    }
+
+    MicroSecondDelay (Delay);
+  }
+}
+
 STATIC
 EFI_STATUS
 DwHdmiI2cRead (
@@ -201,9 +257,10 @@ DwHdmiI2cRead (
 {
   struct DwHdmiQpI2c  *I2c = &Hdmi->I2c;
   EFI_STATUS          Status;
-  UINT32              Timeout;
   INT32               Retry;
   UINT32              Intr;
+  UINTN               Count;
+  UINTN               Index;
 
   if (!I2c->IsRegAddr) {
     I2c->SlaveReg  = 0x0;
@@ -213,10 +270,17 @@ DwHdmiI2cRead (
   /*
    * Note: I2CM_NBYTES > 0 seems broken - it triggers I2CM_OP_DONE_IRQ
    * before actually finishing the transfer, so we may read bogus data.
-   * Read one byte at a time instead.
+   * Read one byte at a time, unless the caller asked for block reads
+   * and validates the result itself.
    */
 
-  while (Length--) {
+  while (Length > 0) {
+    Count = I2c->BlockRead ? MIN (Length, HDMI_I2C_BLOCK_READ_SIZE) : 1;
+
+    if (I2c->BlockRead) {
+      DwHdmiQpRegMod (Hdmi, (Count - 1) << 20, I2CM_NBYTES, I2CM_INTERFACE_CONTROL0);
+    }
+
     DwHdmiQpRegMod (Hdmi, I2c->SlaveReg << 12, I2CM_ADDR, I2CM_INTERFACE_CONTROL0);
 
     for (Retry = 50; Retry > 0;) {
@@ -231,19 +295,8 @@ DwHdmiI2cRead (
         DwHdmiQpRegMod (Hdmi, I2CM_FM_READ, I2CM_WR_MASK, I2CM_INTERFACE_CONTROL0);
       }
 
-      for (Timeout = 20; Timeout > 0; Timeout--) {
-        MicroSecondDelay (1000);
-        Intr  = DwHdmiQpRegRead (Hdmi, MAINUNIT_1_INT_STATUS);
-        Intr &= (I2CM_OP_DONE_IRQ |
-                 I2CM_READ_REQUEST_IRQ |
-                 I2CM_NACK_RCVD_IRQ);
-        if (Intr) {
-          DwHdmiQpRegWrite (Hdmi, Intr, MAINUNIT_1_INT_CLEAR);
-          break;
-        }
-      }
-
-      if (Timeout == 0) {
+      Intr = DwHdmiI2cWaitForInterrupt (Hdmi, Count);
+      if (Intr == 0) {
         DEBUG ((
           DEBUG_ERROR,
           "%a: Timed out at offset 0x%x. Retry=%d\n",
@@ -288,16 +341,20 @@ DwHdmiI2cRead (
       return Status;
     }
 
-    *Buf = DwHdmiQpRegRead (Hdmi, I2CM_INTERFACE_RDDATA_0_3) & 0xff;
-    DEBUG ((
-      DEBUG_VERBOSE,
-      "%a: [0x%02x] = 0x%02x\n",
-      __func__,
-      I2c->SlaveReg,
-      *Buf
-      ));
-    Buf++;
-    I2c->SlaveReg++;
+    for (Index = 0; Index < Count; Index++) {
+      *Buf = (DwHdmiQpRegRead (Hdmi, I2CM_INTERFACE_RDDATA_0_3 + (Index & ~3)) >> ((Index & 3) * 8)) & 0xff;
+      DEBUG ((
+        DEBUG_VERBOSE,
+        "%a: [0x%02x] = 0x%02x\n",
+        __func__,
+        I2c->SlaveReg,
+        *Buf
+        ));
+      Buf++;
+      I2c->SlaveReg++;
+    }
+
+    Length -= Count;
 
     DwHdmiQpRegMod (Hdmi, 0, I2CM_WR_MASK, I2CM_INTERFACE_CONTROL0);
   }
@@ -317,7 +374,6 @@ DwHdmiI2cWrite (
 {
   struct DwHdmiQpI2c  *I2c = &Hdmi->I2c;
   EFI_STATUS          Status;
-  UINT32              Timeout;
   INT32               Retry;
   UINT32              Intr;
 
@@ -339,19 +395,8 @@ DwHdmiI2cWrite (
       DwHdmiQpRegMod (Hdmi, I2c->SlaveReg << 12, I2CM_ADDR, I2CM_INTERFACE_CONTROL0);
       DwHdmiQpRegMod (Hdmi, I2CM_FM_WRITE, I2CM_WR_MASK, I2CM_INTERFACE_CONTROL0);
 
-      for (Timeout = 20; Timeout > 0; Timeout--) {
-        MicroSecondDelay (1000);
-        Intr  = DwHdmiQpRegRead (Hdmi, MAINUNIT_1_INT_STATUS);
-        Intr &= (I2CM_OP_DONE_IRQ |
-                 I2CM_READ_REQUEST_IRQ |
-                 I2CM_NACK_RCVD_IRQ);
-        if (Intr) {
-          DwHdmiQpRegWrite (Hdmi, Intr, MAINUNIT_1_INT_CLEAR);
-          break;
-        }
-      }
-
-      if (Timeout == 0) {
+      Intr = DwHdmiI2cWaitForInterrupt (Hdmi, 1);
+      if (Intr == 0) {
         DEBUG ((
           DEBUG_ERROR,
           "%a: Timed out at offset 0x%x. Retry=%d\n",
@@ -533,6 +578,8 @@ DwHdmiI2cInit (
 
   DwHdmiQpRegMod (Hdmi, 0, I2CM_FM_EN, I2CM_INTERFACE_CONTROL0);
 
+  Hdmi->I2c.BlockReadSupported = FixedPcdGetBool (PcdHdmiDdcBlockRead);
+
   /* Clear DONE and ERROR interrupts */
   DwHdmiQpRegWrite (
     Hdmi,
@@ -593,11 +640,12 @@ EFI_STATUS
 DwHdmiReadEdidBlock (
   IN  struct DwHdmiQpDevice  *Hdmi,
   IN  UINT8                  BlockIndex,
+  IN  UINT8                  Offset,
   OUT UINT8                  *Buffer,
   IN  UINTN                  Length
   )
 {
-  UINT8  BaseAddr = BlockIndex * EDID_BLOCK_SIZE;
+  UINT8  BaseAddr = BlockIndex * EDID_BLOCK_SIZE + Offset;
   UINT8  Segment  = BlockIndex >> 1;
 
   struct i2c_msg  Msgs[] = {
@@ -660,6 +708,163 @@ DwHdmiQpConnectorInit (
   return EFI_SUCCESS;
 }
 
+/*
+ * Try a multi-byte read first and accept it if the block checksum holds.
+ * Otherwise read the block again one byte at a time, and stop using
+ * multi-byte reads if they returned different data.
+ */
+STATIC
+EFI_STATUS
+DwHdmiReadEdidBlockFast (
+  IN  struct DwHdmiQpDevice  *Hdmi,
+  IN  UINT8                  BlockIndex,
+  OUT UINT8                  *Buffer
+  )
+{
+  EFI_STATUS  Status;
+  EFI_STATUS  BlockStatus;
+  UINT8       BlockBuffer[EDID_BLOCK_SIZE];
+
+  if (!Hdmi->I2c.BlockReadSupported) {
+    return DwHdmiReadEdidBlock (Hdmi, BlockIndex, 0, Buffer, EDID_BLOCK_SIZE);
+  }
+
+  Hdmi->I2c.BlockRead = TRUE;
+  BlockStatus         = DwHdmiReadEdidBlock (Hdmi, BlockIndex, 0, BlockBuffer, EDID_BLOCK_SIZE);
+  Hdmi->I2c.BlockRead = FALSE;
+
+  DwHdmiQpRegMod (Hdmi, 0, I2CM_NBYTES, I2CM_INTERFACE_CONTROL0);
+
+  if (!EFI_ERROR (BlockStatus) && IsEdidBlockChecksumValid (BlockBuffer)) {
+    CopyMem (Buffer, BlockBuffer, EDID_BLOCK_SIZE);
+    return EFI_SUCCESS;
+  }
+
+  Status = DwHdmiReadEdidBlock (Hdmi, BlockIndex, 0, Buffer, EDID_BLOCK_SIZE);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  if (EFI_ERROR (BlockStatus) || (CompareMem (Buffer, BlockBuffer, EDID_BLOCK_SIZE) != 0)) {
+    DEBUG ((
+      DEBUG_WARN,
+      "%a: Block reads unreliable (%r), using byte reads.\n",
+      __func__,
+      BlockStatus
+      ));
+    Hdmi->I2c.BlockReadSupported = FALSE;
+  }
+
+  return EFI_SUCCESS;
+}
+
+STATIC
+VOID
+DwHdmiGetEdidCacheVariableName (
+  IN  struct DwHdmiQpDevice  *Hdmi,
+  OUT CHAR16                 *VariableName,
+  IN  UINTN                  VariableNameSize
+  )
+{
+  UnicodeSPrint (VariableName, VariableNameSize, L"HdmiEdidCache%u", Hdmi->Id);
+}
+
+/*
+ * Load the EDID cached by a previous boot and check that the same sink is
+ * still attached, by reading back only its identification bytes and the
+ * checksum of every block instead of the whole EDID.
+ */
+STATIC
+EFI_STATUS
+DwHdmiLoadCachedEdid (
+  IN  struct DwHdmiQpDevice  *Hdmi,
+  OUT UINT8                  *Edid
+  )
+{
+  EFI_STATUS  Status;
+  CHAR16      VariableName[32];
+  UINTN       Size;
+  UINT32      BlockIndex;
+  UINT8       Id[HDMI_EDID_ID_SIZE];
+  UINT8       Checksum;
+
+  DwHdmiGetEdidCacheVariableName (Hdmi, VariableName, sizeof (VariableName));
+
+  Size   = EDID_MAX_SIZE;
+  Status = gRT->GetVariable (
+                  VariableName,
+                  &gHdmiEdidCacheVariableGuid,
+                  NULL,
+                  &Size,
+                  Edid
+                  );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  if ((Size < EDID_BLOCK_SIZE) || (Size != EDID_GET_SIZE (Edid))) {
+    return EFI_VOLUME_CORRUPTED;
+  }
+
+  for (BlockIndex = 0; BlockIndex < EDID_GET_BLOCK_COUNT (Edid); BlockIndex++) {
+    Status = CheckEdidBlock (EDID_BLOCK (Edid, BlockIndex), BlockIndex);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  Status = DwHdmiReadEdidBlock (Hdmi, 0, 0, Id, sizeof (Id));
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  if (CompareMem (Id, Edid, sizeof (Id)) != 0) {
+    return EFI_NOT_FOUND;
+  }
+
+  for (BlockIndex = 0; BlockIndex < EDID_GET_BLOCK_COUNT (Edid); BlockIndex++) {
+    Status = DwHdmiReadEdidBlock (Hdmi, BlockIndex, EDID_BLOCK_SIZE - 1, &Checksum, 1);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    if (Checksum != EDID_BLOCK (Edid, BlockIndex)[EDID_BLOCK_SIZE - 1]) {
+      return EFI_NOT_FOUND;
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
+STATIC
+VOID
+DwHdmiSaveCachedEdid (
+  IN struct DwHdmiQpDevice  *Hdmi,
+  IN UINT8                  *Edid
+  )
+{
+  EFI_STATUS  Status;
+  CHAR16      VariableName[32];
+
+  DwHdmiGetEdidCacheVariableName (Hdmi, VariableName, sizeof (VariableName));
+
+  Status = gRT->SetVariable (
+                  VariableName,
+                  &gHdmiEdidCacheVariableGuid,
+                  EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_BOOTSERVICE_ACCESS,
+                  EDID_GET_SIZE (Edid),
+                  Edid
+                  );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((
+      DEBUG_WARN,
+      "%a: Failed to save EDID cache. Status=%r\n",
+      __func__,
+      Status
+      ));
+  }
+}
+
 EFI_STATUS
 DwHdmiQpConnectorGetEdid (
   OUT ROCKCHIP_CONNECTOR_PROTOCOL  *This,
@@ -677,11 +882,22 @@ DwHdmiQpConnectorGetEdid (
   Hdmi           = DW_HDMI_QP_FROM_CONNECTOR_PROTOCOL (This);
   ConnectorState = &DisplayState->ConnectorState;
 
+  if (FixedPcdGetBool (PcdHdmiEdidCache)) {
+    Status = DwHdmiLoadCachedEdid (Hdmi, ConnectorState->Edid);
+    if (!EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_INFO, "%a: Using cached EDID\n", __func__));
+      return EFI_SUCCESS;
+    }
+
+    DEBUG ((DEBUG_INFO, "%a: EDID cache miss. Status=%r\n", __func__, Status));
+    ZeroMem (ConnectorState->Edid, sizeof (ConnectorState->Edid));
+  }
+
   for (BlockIndex = 0, Extensions = 0; BlockIndex <= Extensions; BlockIndex++) {
     Buffer = EDID_BLOCK (ConnectorState->Edid, BlockIndex);
 
     for (Retry = HDMI_EDID_BLOCK_RETRIES; Retry > 0; Retry--) {
-      Status = DwHdmiReadEdidBlock (Hdmi, BlockIndex, Buffer, EDID_BLOCK_SIZE);
+      Status = DwHdmiReadEdidBlockFast (Hdmi, BlockIndex, Buffer);
       if (EFI_ERROR (Status)) {
         DEBUG ((
           DEBUG_ERROR,
@@ -721,6 +937,10 @@ DwHdmiQpConnectorGetEdid (
     }
   }
 
+  if (FixedPcdGetBool (PcdHdmiEdidCache)) {
+    DwHdmiSaveCachedEdid (Hdmi, ConnectorState->Edid);
+  }
+
   return EFI_SUCCESS;
 }
 
@@ -1059,7 +1279,19 @@ DwHdmiQpConnectorDisable (
   OUT DISPLAY_STATE                *DisplayState
   )
 {
-  // Todo
+  struct DwHdmiQpDevice  *Hdmi;
+
+  Hdmi = DW_HDMI_QP_FROM_CONNECTOR_PROTOCOL (This);
+
+  if ((DwHdmiQpRegRead (Hdmi, LINK_CONFIG0) & OPMODE_DVI) == 0) {
+    /* set avmute and give the sink a frame to blank */
+    DwHdmiQpRegWrite (Hdmi, 1, PKTSCHED_PKT_CONTROL0);
+    DwHdmiQpRegMod (Hdmi, PKTSCHED_GCP_TX_EN, PKTSCHED_GCP_TX_EN, PKTSCHED_PKT_EN);
+    MicroSecondDelay (50 * 1000);
+  }
+
+  HdptxPowerOff (&Hdmi->HdptxPhy);
+
   return EFI_SUCCESS;
 }
 
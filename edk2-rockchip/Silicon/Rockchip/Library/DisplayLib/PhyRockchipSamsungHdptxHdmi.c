@@ -1402,3 +1402,15 @@ HdptxRopllTmdsModeConfig (
 
   return HdptxPostEnableLane (Hdptx);
 }
+
+VOID
+HdptxPowerOff (
+  OUT struct RockchipHdptxPhyHdmi  *Hdptx
+  )
+{
+  /*
+   * Hold the lanes and PLL in reset with bias off, the same state
+   * HdptxRopllCmnConfig starts from.
+   */
+  HdptxPrePowerUp (Hdptx);
+}
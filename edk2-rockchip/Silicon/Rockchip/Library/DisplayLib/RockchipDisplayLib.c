@@ -205,7 +205,6 @@ GetVopOutputIfName (
   }
 }
 
-STATIC
 BOOLEAN
 IsEdidBlockChecksumValid (
   IN UINT8  *EdidBlock
@@ -5,6 +5,7 @@
  */
 
 #include "Soc.h"
+#include <Library/BaseMemoryLib.h>
 #include <Library/DebugLib.h>
 #include <Library/IoLib.h>
 #include <Library/PcdLib.h>
@@ -51,6 +52,7 @@
 
 /* FSPI_RISR */
 #define FSPI_RISR_TRANSS_ACTIVE  (1 << FSPI_RISR_TRANSS_SHIFT)
+#define FSPI_RISR_DMAS_ACTIVE    (1 << FSPI_RISR_DMAS_SHIFT)
 
 /* FSPI attributes */
 #define FSPI_VER_VER_1  1
@@ -395,6 +397,53 @@ HAL_FSPI_XferData (
   return ret;
 }
 
+/**
+ * @brief  DMA transfer through the host bounce buffer.
+ * @param  host: FSPI host.
+ * @param  len: data n bytes, multiple of 4 and at most host->dmaBufferSize.
+ * @param  data: transfer buffer.
+ * @param  dir: transfer direction.
+ * @return RETURN_STATUS.
+ */
+RETURN_STATUS
+HAL_FSPI_XferData_DMA (
+  struct HAL_FSPI_HOST  *host,
+  UINT32                len,
+  void                  *data,
+  UINT32                dir
+  )
+{
+  RETURN_STATUS    ret     = RETURN_SUCCESS;
+  INT32            timeout = 0;
+  struct FSPI_REG  *pReg   = host->instance;
+
+  HAL_ASSERT (data && len && host->dmaBuffer);
+
+  if (dir == FSPI_WRITE) {
+    CopyMem (host->dmaBuffer, data, len);
+  }
+
+  pReg->ICLR    = 0xFFFFFFFF;
+  pReg->DMAADDR = host->dmaBufferAddr;
+  pReg->DMATR   = FSPI_DMATR_DMATR_START;
+
+  while (!(pReg->RISR & FSPI_RISR_DMAS_ACTIVE)) {
+    HAL_CPUDelayUs (1);
+    if (timeout++ > 100000) {
+      ret = RETURN_TIMEOUT;
+      break;
+    }
+  }
+
+  pReg->ICLR = 0xFFFFFFFF;
+
+  if ((ret == RETURN_SUCCESS) && (dir == FSPI_READ)) {
+    CopyMem (data, host->dmaBuffer, len);
+  }
+
+  return ret;
+}
+
 /**
  * @brief  Wait for FSPI host transfer finished.
  * @return RETURN_STATUS.
@@ -449,7 +498,21 @@ HAL_FSPI_SpiXfer (
 
   HAL_FSPI_XferStart (host, op);
   if (pData) {
-    ret = HAL_FSPI_XferData (host, op->data.nbytes, pData, dir);
+    /* Short and odd sized transfers are not worth the DMA setup */
+    if (host->dmaBuffer &&
+        (op->data.nbytes >= FSPI_DMA_MIN_SIZE) &&
+        (op->data.nbytes <= host->dmaBufferSize) &&
+        HAL_IS_ALIGNED (op->data.nbytes, 4))
+    {
+      host->xferMode  = FSPI_XFER_MODE_DMA;
+      host->dmaBytes += op->data.nbytes;
+      ret             = HAL_FSPI_XferData_DMA (host, op->data.nbytes, pData, dir);
+    } else {
+      host->xferMode  = FSPI_XFER_MODE_PIO;
+      host->pioBytes += op->data.nbytes;
+      ret             = HAL_FSPI_XferData (host, op->data.nbytes, pData, dir);
+    }
+
     if (ret) {
       FSPI_DBG ("%s xfer data failed ret %d\n", __func__, ret);
 
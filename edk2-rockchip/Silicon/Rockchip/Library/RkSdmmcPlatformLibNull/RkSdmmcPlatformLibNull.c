@@ -37,3 +37,13 @@ RkSdmmcGetCardPresenceState (
 {
   return RkSdmmcCardPresenceUnsupported;
 }
+
+EFI_STATUS
+EFIAPI
+RkSdmmcSetClockPhase (
+  IN RKSDMMC_CLOCK_PHASE_TYPE  Type,
+  IN UINT32                    Degrees
+  )
+{
+  return EFI_UNSUPPORTED;
+}
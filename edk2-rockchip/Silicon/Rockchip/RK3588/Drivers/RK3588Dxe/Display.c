@@ -178,6 +178,19 @@ InitializeDisplayVariables (
     ASSERT_EFI_ERROR (Status);
   }
 
+  Size   = sizeof (Var16);
+  Status = !Reset ? gRT->GetVariable (
+                           L"DisplayMaxConsoleHeight",
+                           &gRK3588DxeFormSetGuid,
+                           NULL,
+                           &Size,
+                           &Var16
+                           ) : EFI_NOT_FOUND;
+  if (EFI_ERROR (Status)) {
+    Status = PcdSet16S (PcdDisplayMaxConsoleHeight, FixedPcdGet16 (PcdDisplayMaxConsoleHeightDefault));
+    ASSERT_EFI_ERROR (Status);
+  }
+
   Size   = sizeof (Var8);
   Status = !Reset ? gRT->GetVariable (
                            L"HdmiSignalingMode",
@@ -0,0 +1,18 @@
+/** @file
+ *
+ *  Vendor GUID of the non-volatile variables holding the EDID of the sink
+ *  last attached to each HDMI port ("HdmiEdidCache<Id>").
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#ifndef __HDMI_EDID_CACHE_H__
+#define __HDMI_EDID_CACHE_H__
+
+#define HDMI_EDID_CACHE_VARIABLE_GUID \
+  { 0x54382043, 0x4c0a, 0x49f9, { 0xb4, 0xf2, 0x27, 0xea, 0x9e, 0xdb, 0x7b, 0xba } }
+
+extern EFI_GUID  gHdmiEdidCacheVariableGuid;
+
+#endif // __HDMI_EDID_CACHE_H__
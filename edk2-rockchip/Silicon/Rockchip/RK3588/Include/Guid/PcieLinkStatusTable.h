@@ -0,0 +1,54 @@
+/** @file
+ *
+ *  PCIe link status configuration table, installed by Rk3588PciHostBridgeLib
+ *  after link training so that degraded links can be monitored.
+ *
+ *  SPDX-License-Identifier: BSD-2-Clause-Patent
+ *
+ **/
+
+#ifndef __PCIE_LINK_STATUS_TABLE_H__
+#define __PCIE_LINK_STATUS_TABLE_H__
+
+#define PCIE_LINK_STATUS_TABLE_GUID \
+  { 0x6d0b2c1e, 0x5f3a, 0x4c8e, { 0x9a, 0x41, 0x2e, 0x7b, 0x83, 0xd6, 0x15, 0xc9 } }
+
+#define PCIE_LINK_STATUS_TABLE_REVISION  1
+#define PCIE_LINK_STATUS_MAX_SEGMENTS    5
+
+//
+// Flags
+//
+#define PCIE_LINK_STATUS_ENABLED   BIT0
+#define PCIE_LINK_STATUS_LINK_UP   BIT1
+#define PCIE_LINK_STATUS_DEGRADED  BIT2
+
+//
+// EqStatus mirrors bits 5:1 of the root port's Link Status 2 register.
+//
+#define PCIE_LINK_STATUS_EQ_COMPLETE  BIT0
+#define PCIE_LINK_STATUS_EQ_PHASE1    BIT1
+#define PCIE_LINK_STATUS_EQ_PHASE2    BIT2
+#define PCIE_LINK_STATUS_EQ_PHASE3    BIT3
+#define PCIE_LINK_STATUS_EQ_REQUEST   BIT4
+
+typedef struct {
+  UINT8    Flags;
+  UINT8    Speed;         // Negotiated link speed (1 = 2.5 GT/s, 2 = 5 GT/s, 3 = 8 GT/s)
+  UINT8    Width;         // Negotiated link width
+  UINT8    MaxSpeed;      // Highest speed supported by both ends of the link
+  UINT8    MaxWidth;      // Widest width supported by both ends of the link
+  UINT8    EqStatus;
+  UINT8    RetrainCount;
+  UINT8    Reserved;
+} PCIE_LINK_STATUS;
+
+typedef struct {
+  UINT32              Revision;
+  UINT32              Count;
+  PCIE_LINK_STATUS    Links[PCIE_LINK_STATUS_MAX_SEGMENTS];
+} PCIE_LINK_STATUS_TABLE;
+
+extern EFI_GUID  gPcieLinkStatusTableGuid;
+
+#endif // __PCIE_LINK_STATUS_TABLE_H__
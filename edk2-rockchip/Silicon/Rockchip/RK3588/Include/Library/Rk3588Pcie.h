@@ -64,4 +64,13 @@ PciePinmuxInit (
 
 #define PCIE_BUS_LIMIT  252 // limited by CFG1 iATU window size
 
+//
+// Provided by Rk3588PciSegmentLib.
+//
+UINT64
+EFIAPI
+PciSegmentLibGetConfigAccessCount (
+  IN BOOLEAN  Reset
+  );
+
 #endif
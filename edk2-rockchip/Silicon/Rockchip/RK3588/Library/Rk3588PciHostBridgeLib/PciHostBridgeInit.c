@@ -11,17 +11,21 @@
 
 #include <PiDxe.h>
 #include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
 #include <Library/PrintLib.h>
 #include <Library/DebugLib.h>
 #include <Library/IoLib.h>
+#include <Library/MemoryAllocationLib.h>
 #include <Library/GpioLib.h>
 #include <Library/CruLib.h>
 #include <Library/GpioLib.h>
 #include <Library/Rk3588Pcie.h>
 #include <Library/RockchipPlatformLib.h>
 #include <Library/Pcie30PhyLib.h>
+#include <Library/TimerLib.h>
 #include <Library/UefiBootServicesTableLib.h>
 #include <IndustryStandard/Pci.h>
+#include <Guid/PcieLinkStatusTable.h>
 #include <VarStoreData.h>
 
 #include "PciHostBridgeInit.h"
@@ -45,6 +49,8 @@
 #define  RDLH_LINK_UP                   BIT17
 #define  SMLH_LINK_UP                   BIT16
 #define  SMLH_LTSSM_STATE_MASK          0x3f
+#define  SMLH_LTSSM_STATE_DETECT_QUIET  0x00
+#define  SMLH_LTSSM_STATE_DETECT_ACT    0x01
 #define  SMLH_LTSSM_STATE_LINK_UP       0x11
 
 /* DBI Registers */
@@ -54,11 +60,15 @@
 #define PCI_BAR1                  0x0014
 #define PCIE_LINK_CAPABILITY      0x007C
 #define PCIE_LINK_STATUS          0x0080
+#define  LINK_CONTROL_RETRAIN     BIT5
+#define  LINK_STATUS_TRAINING     BIT27
 #define  LINK_STATUS_WIDTH_SHIFT  20
 #define  LINK_STATUS_WIDTH_MASK   (0xFU << LINK_STATUS_WIDTH_SHIFT)
 #define  LINK_STATUS_SPEED_SHIFT  16
 #define  LINK_STATUS_SPEED_MASK   (0xFU << LINK_STATUS_SPEED_SHIFT)
 #define PCIE_LINK_CTL_2           0x00A0
+#define  LINK_STATUS_2_EQ_SHIFT   17
+#define  LINK_STATUS_2_EQ_MASK    (0x1FU << LINK_STATUS_2_EQ_SHIFT)
 #define PL_PORT_LINK_CTRL_OFF     0x0710
 #define  LINK_CAPABLE_SHIFT       16
 #define  LINK_CAPABLE_MASK        (0x3FU << LINK_CAPABLE_SHIFT)
@@ -73,6 +83,19 @@
 
 #define PCIE_TYPE0_HDR_DBI2_OFFSET  0x100000
 
+/* Link up polling interval, shared by all the segments being brought up */
+#define PCIE_LINK_UP_POLL_INTERVAL_US  1000
+
+/* Link retraining, when the link comes up below its capability */
+#define PCIE_LINK_RETRAIN_ATTEMPTS    3
+#define PCIE_LINK_RETRAIN_TIMEOUT_US  100000
+
+/* Link Capabilities in the PCI Express capability of the downstream device */
+#define PCIE_CAP_LINK_CAPABILITY  0x0C
+#define  LINK_CAP_SPEED_MASK      0xFU
+#define  LINK_CAP_WIDTH_SHIFT     4
+#define  LINK_CAP_WIDTH_MASK      (0x3FU << LINK_CAP_WIDTH_SHIFT)
+
 /* ATU Registers */
 #define ATU_CAP_BASE  0x300000
 #define IATU_REGION_CTRL_OUTBOUND(n)  (ATU_CAP_BASE + ((n) << 9))
@@ -362,6 +385,7 @@ PciGetLinkSpeedWidth (
 STATIC
 VOID
 PciPrintLinkSpeedWidth (
+  IN UINT32  Segment,
   IN UINT32  Speed,
   IN UINT32  Width
   )
@@ -395,7 +419,7 @@ PciPrintLinkSpeedWidth (
       break;
   }
 
-  DEBUG ((DEBUG_INIT, "PCIe: Link up (x%u, %a GT/s)\n", Width, LinkSpeedBuf));
+  DEBUG ((DEBUG_INIT, "PCIe %u: Link up (x%u, %a GT/s)\n", Segment, Width, LinkSpeedBuf));
 }
 
 STATIC
@@ -419,16 +443,17 @@ PciEnableLtssm (
 STATIC
 BOOLEAN
 PciIsLinkUp (
+  IN UINT32                Segment,
   IN EFI_PHYSICAL_ADDRESS  ApbBase
   )
 {
-  STATIC UINT32  LastVal = 0xFFFFFFFF;
+  STATIC UINT32  LastVal[NUM_PCIE_CONTROLLER] = { 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF };
   UINT32         Val;
 
   Val = MmioRead32 (ApbBase + PCIE_CLIENT_LTSSM_STATUS);
-  if (Val != LastVal) {
-    DEBUG ((DEBUG_INIT, "PCIe: PciIsLinkUp(): LTSSM_STATUS=0x%08X\n", Val));
-    LastVal = Val;
+  if (Val != LastVal[Segment]) {
+    DEBUG ((DEBUG_INIT, "PCIe %u: PciIsLinkUp(): LTSSM_STATUS=0x%08X\n", Segment, Val));
+    LastVal[Segment] = Val;
   }
 
   if ((Val & RDLH_LINK_UP) == 0) {
@@ -442,6 +467,34 @@ PciIsLinkUp (
   return (Val & SMLH_LTSSM_STATE_MASK) == SMLH_LTSSM_STATE_LINK_UP;
 }
 
+/*
+ * The LTSSM loops between Detect.Quiet and Detect.Active until it sees a
+ * receiver on the lanes, and only then moves on to Polling.
+ */
+STATIC
+BOOLEAN
+PciIsReceiverDetected (
+  IN EFI_PHYSICAL_ADDRESS  ApbBase
+  )
+{
+  UINT32  State;
+
+  State = MmioRead32 (ApbBase + PCIE_CLIENT_LTSSM_STATUS) & SMLH_LTSSM_STATE_MASK;
+
+  return (State != SMLH_LTSSM_STATE_DETECT_QUIET) && (State != SMLH_LTSSM_STATE_DETECT_ACT);
+}
+
+STATIC
+VOID
+PciPowerOffSlot (
+  IN UINT32  Segment
+  )
+{
+  PciEnableLtssm (PCIE_APB_BASE (Segment), FALSE);
+  PciePeReset (Segment, TRUE);
+  PciePowerEn (Segment, FALSE);
+}
+
 STATIC
 VOID
 PciSetupAtu (
@@ -525,6 +578,198 @@ PciValidateCfg0 (
   }
 }
 
+STATIC
+UINT8
+PciGetEqualizationStatus (
+  IN EFI_PHYSICAL_ADDRESS  DbiBase
+  )
+{
+  return (MmioRead32 (DbiBase + PCIE_LINK_CTL_2) & LINK_STATUS_2_EQ_MASK) >> LINK_STATUS_2_EQ_SHIFT;
+}
+
+/*
+ * Retrain the link towards the target speed programmed by PciSetupLinkSpeed(),
+ * and wait for the training to finish.
+ */
+STATIC
+EFI_STATUS
+PciRetrainLink (
+  IN UINT32                Segment,
+  IN EFI_PHYSICAL_ADDRESS  DbiBase
+  )
+{
+  UINT32  Timeout;
+
+  MmioAnd32 (DbiBase + PL_GEN2_CTRL_OFF, ~DIRECT_SPEED_CHANGE);
+  MmioOr32 (DbiBase + PL_GEN2_CTRL_OFF, DIRECT_SPEED_CHANGE);
+
+  /* Only touch Link Control, Link Status has write-1-to-clear bits */
+  MmioOr16 (DbiBase + PCIE_LINK_STATUS, LINK_CONTROL_RETRAIN);
+
+  for (Timeout = 0; Timeout < PCIE_LINK_RETRAIN_TIMEOUT_US; Timeout += PCIE_LINK_UP_POLL_INTERVAL_US) {
+    gBS->Stall (PCIE_LINK_UP_POLL_INTERVAL_US);
+
+    if (  ((MmioRead32 (DbiBase + PCIE_LINK_STATUS) & LINK_STATUS_TRAINING) == 0)
+       && PciIsLinkUp (Segment, PCIE_APB_BASE (Segment)))
+    {
+      return EFI_SUCCESS;
+    }
+  }
+
+  return EFI_TIMEOUT;
+}
+
+/*
+ * Read the link capabilities of the device behind the root port, walking its
+ * capability list through the CFG0 window.
+ */
+STATIC
+EFI_STATUS
+PciGetDeviceLinkCapability (
+  IN  EFI_PHYSICAL_ADDRESS  Cfg0Base,
+  OUT UINT32                *Speed,
+  OUT UINT32                *Width
+  )
+{
+  UINT8   CapPtr;
+  UINT8   CapId;
+  UINT32  Count;
+  UINT32  Val;
+
+  if ((MmioRead16 (Cfg0Base + PCI_STATUS_OFFSET) & EFI_PCI_STATUS_CAPABILITY) == 0) {
+    return EFI_NOT_FOUND;
+  }
+
+  CapPtr = MmioRead8 (Cfg0Base + PCI_CAPBILITY_POINTER_OFFSET) & ~0x3;
+
+  /* Bound the walk in case the list is looped */
+  for (Count = 0; (CapPtr >= 0x40) && (Count < 48); Count++) {
+    CapId = MmioRead8 (Cfg0Base + CapPtr);
+    if (CapId == EFI_PCI_CAPABILITY_ID_PCIEXP) {
+      Val    = MmioRead32 (Cfg0Base + CapPtr + PCIE_CAP_LINK_CAPABILITY);
+      *Speed = Val & LINK_CAP_SPEED_MASK;
+      *Width = (Val & LINK_CAP_WIDTH_MASK) >> LINK_CAP_WIDTH_SHIFT;
+      return EFI_SUCCESS;
+    }
+
+    CapPtr = MmioRead8 (Cfg0Base + CapPtr + 1) & ~0x3;
+  }
+
+  return EFI_NOT_FOUND;
+}
+
+/*
+ * Check that the link came up at the best speed and width supported by both
+ * ends, and retrain it a few times if it didn't.
+ */
+STATIC
+VOID
+PciVerifyLink (
+  IN  UINT32            Segment,
+  IN  UINT32            MaxSpeed,
+  IN  UINT32            MaxWidth,
+  OUT PCIE_LINK_STATUS  *LinkStatus
+  )
+{
+  EFI_PHYSICAL_ADDRESS  DbiBase = PCIE_DBI_BASE (Segment);
+  EFI_STATUS            Status;
+  UINT32                DeviceSpeed;
+  UINT32                DeviceWidth;
+  UINT32                Speed;
+  UINT32                Width;
+  UINT32                Attempt;
+
+  /* CFG0 window as set up by PciSetupController() */
+  Status = PciGetDeviceLinkCapability (PCIE_CFG_BASE (Segment) + SIZE_1MB, &DeviceSpeed, &DeviceWidth);
+  if (!EFI_ERROR (Status)) {
+    if ((DeviceSpeed != 0) && (DeviceSpeed < MaxSpeed)) {
+      MaxSpeed = DeviceSpeed;
+    }
+
+    if ((DeviceWidth != 0) && (DeviceWidth < MaxWidth)) {
+      MaxWidth = DeviceWidth;
+    }
+  }
+
+  for (Attempt = 0; ; Attempt++) {
+    PciGetLinkSpeedWidth (DbiBase, &Speed, &Width);
+    if ((Speed >= MaxSpeed) && (Width >= MaxWidth)) {
+      break;
+    }
+
+    if (Attempt == PCIE_LINK_RETRAIN_ATTEMPTS) {
+      DEBUG ((
+        DEBUG_WARN,
+        "PCIe %u: Link degraded to Gen%u x%u, capable of Gen%u x%u\n",
+        Segment,
+        Speed,
+        Width,
+        MaxSpeed,
+        MaxWidth
+        ));
+      LinkStatus->Flags |= PCIE_LINK_STATUS_DEGRADED;
+      break;
+    }
+
+    DEBUG ((
+      DEBUG_INFO,
+      "PCIe %u: Link at Gen%u x%u, capable of Gen%u x%u, retraining (%u/%u)\n",
+      Segment,
+      Speed,
+      Width,
+      MaxSpeed,
+      MaxWidth,
+      Attempt + 1,
+      PCIE_LINK_RETRAIN_ATTEMPTS
+      ));
+
+    Status = PciRetrainLink (Segment, DbiBase);
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_WARN, "PCIe %u: Link retraining failed: %r\n", Segment, Status));
+    }
+  }
+
+  LinkStatus->Speed        = (UINT8)Speed;
+  LinkStatus->Width        = (UINT8)Width;
+  LinkStatus->MaxSpeed     = (UINT8)MaxSpeed;
+  LinkStatus->MaxWidth     = (UINT8)MaxWidth;
+  LinkStatus->RetrainCount = (UINT8)Attempt;
+
+  if (MaxSpeed >= 3) {
+    LinkStatus->EqStatus = PciGetEqualizationStatus (DbiBase);
+    DEBUG ((
+      DEBUG_INFO,
+      "PCIe %u: Gen3 equalization %acomplete (phase 1: %d, phase 2: %d, phase 3: %d)\n",
+      Segment,
+      (LinkStatus->EqStatus & PCIE_LINK_STATUS_EQ_COMPLETE) ? "" : "not ",
+      (LinkStatus->EqStatus & PCIE_LINK_STATUS_EQ_PHASE1) != 0,
+      (LinkStatus->EqStatus & PCIE_LINK_STATUS_EQ_PHASE2) != 0,
+      (LinkStatus->EqStatus & PCIE_LINK_STATUS_EQ_PHASE3) != 0
+      ));
+  }
+}
+
+STATIC
+VOID
+PciPublishLinkStatus (
+  IN PCIE_LINK_STATUS_TABLE  *Table
+  )
+{
+  PCIE_LINK_STATUS_TABLE  *Published;
+  EFI_STATUS              Status;
+
+  Published = AllocateCopyPool (sizeof (*Table), Table);
+  if (Published == NULL) {
+    return;
+  }
+
+  Status = gBS->InstallConfigurationTable (&gPcieLinkStatusTableGuid, Published);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_WARN, "PCIe: Failed to install link status table: %r\n", Status));
+    FreePool (Published);
+  }
+}
+
 #define NUM_SEGMENTS  5
 #define NUM_MODES     5
 
@@ -569,25 +814,24 @@ STATIC struct {
   },
 };
 
+STATIC
+UINT64
+PciGetElapsedMs (
+  IN UINT64  StartTime
+  )
+{
+  return DivU64x32 (GetTimeInNanoSecond (GetPerformanceCounter () - StartTime), 1000000);
+}
+
+STATIC
 EFI_STATUS
-InitializePciHost (
-  UINT32  Segment
+PciGetSegmentConfig (
+  IN  UINT32  Segment,
+  OUT UINT32  *LinkSpeed,
+  OUT UINT32  *LinkWidth
   )
 {
-  EFI_PHYSICAL_ADDRESS  ApbBase  = PCIE_APB_BASE (Segment);
-  EFI_PHYSICAL_ADDRESS  DbiBase  = PCIE_DBI_BASE (Segment);
-  EFI_PHYSICAL_ADDRESS  PcieBase = PCIE_CFG_BASE (Segment);
-  EFI_STATUS            Status;
-  UINTN                 Retry;
-  UINT32                LinkSpeed;
-  UINT32                LinkWidth;
-  UINT64                Cfg0Base;
-  UINT64                Cfg0Size;
-  UINT64                Cfg1Base;
-  UINT64                Cfg1Size;
-  UINT64                PciIoBase;
-  UINT64                PciIoSize;
-  UINT8                 Pcie30PhyMode;
+  UINT8  Pcie30PhyMode;
 
   Pcie30PhyMode = PcdGet8 (PcdPcie30PhyMode);
   if (Pcie30PhyMode >= NUM_MODES) {
@@ -601,25 +845,35 @@ InitializePciHost (
     return EFI_INVALID_PARAMETER;
   }
 
-  LinkSpeed = LinkSpeedWidthMap[Pcie30PhyMode][Segment].Speed;
-  LinkWidth = LinkSpeedWidthMap[Pcie30PhyMode][Segment].Width;
-  if ((LinkSpeed == 0) || (LinkWidth == 0)) {
+  *LinkSpeed = LinkSpeedWidthMap[Pcie30PhyMode][Segment].Speed;
+  *LinkWidth = LinkSpeedWidthMap[Pcie30PhyMode][Segment].Width;
+  if ((*LinkSpeed == 0) || (*LinkWidth == 0)) {
     /* should never here */
     DEBUG ((DEBUG_WARN, "PCIe: Segment %u not enabled\n", Segment));
     return EFI_UNSUPPORTED;
   }
 
-  /* Log settings */
-  DEBUG ((DEBUG_INIT, "\nPCIe: Segment %u\n", Segment));
-  DEBUG ((DEBUG_INIT, "PCIe: PciExpressBaseAddress 0x%lx\n", PcieBase));
-  DEBUG ((DEBUG_INIT, "PCIe: ApbBase 0x%lx\n", ApbBase));
-  DEBUG ((DEBUG_INIT, "PCIe: DbiBase 0x%lx\n", DbiBase));
-  DEBUG ((DEBUG_INIT, "PCIe: NumLanes %u\n", LinkWidth));
-  DEBUG ((DEBUG_INIT, "PCIe: LinkSpeed %u\n", LinkSpeed));
+  return EFI_SUCCESS;
+}
 
-  PcieIoInit (Segment);
-  PciePowerEn (Segment, TRUE);
-  gBS->Stall (100000);
+STATIC
+EFI_STATUS
+PciSetupController (
+  IN UINT32  Segment,
+  IN UINT32  LinkSpeed,
+  IN UINT32  LinkWidth
+  )
+{
+  EFI_PHYSICAL_ADDRESS  ApbBase  = PCIE_APB_BASE (Segment);
+  EFI_PHYSICAL_ADDRESS  DbiBase  = PCIE_DBI_BASE (Segment);
+  EFI_PHYSICAL_ADDRESS  PcieBase = PCIE_CFG_BASE (Segment);
+  EFI_STATUS            Status;
+  UINT64                Cfg0Base;
+  UINT64                Cfg0Size;
+  UINT64                Cfg1Base;
+  UINT64                Cfg1Size;
+  UINT64                PciIoBase;
+  UINT64                PciIoSize;
 
   if ((Segment == PCIE_SEGMENT_PCIE30X4) || (Segment == PCIE_SEGMENT_PCIE30X2)) {
     /* Configure PCIe 3.0 PHY */
@@ -631,20 +885,20 @@ InitializePciHost (
 
   /* Combo PHY for PCIe 2.0 is configured earlier by RK3588Dxe */
 
-  DEBUG ((DEBUG_INIT, "PCIe: Setup clocks\n"));
+  DEBUG ((DEBUG_INIT, "PCIe %u: Setup clocks\n", Segment));
   PciSetupClocks (Segment);
 
-  DEBUG ((DEBUG_INIT, "PCIe: Switching to RC mode\n"));
+  DEBUG ((DEBUG_INIT, "PCIe %u: Switching to RC mode\n", Segment));
   PciSetRcMode (Segment, ApbBase);
 
   /* Allow writing RO registers through the DBI */
-  DEBUG ((DEBUG_INIT, "PCIe: Enabling DBI access\n"));
+  DEBUG ((DEBUG_INIT, "PCIe %u: Enabling DBI access\n", Segment));
   MmioOr32 (DbiBase + PL_MISC_CONTROL_1_OFF, DBI_RO_WR_EN);
 
-  DEBUG ((DEBUG_INIT, "PCIe: Setup BARs\n"));
+  DEBUG ((DEBUG_INIT, "PCIe %u: Setup BARs\n", Segment));
   PciSetupBars (DbiBase);
 
-  DEBUG ((DEBUG_INIT, "PCIe: Setup iATU\n"));
+  DEBUG ((DEBUG_INIT, "PCIe %u: Setup iATU\n", Segment));
   Cfg0Base  = SIZE_1MB;
   Cfg0Size  = SIZE_64KB;
   Cfg1Base  = SIZE_2MB;
@@ -656,43 +910,230 @@ InitializePciHost (
   PciSetupAtu (DbiBase, 1, IATU_TYPE_CFG1, PcieBase + Cfg1Base, Cfg1Base, Cfg1Size);
   PciSetupAtu (DbiBase, 2, IATU_TYPE_IO, PcieBase + PciIoBase, 0, PciIoSize);
 
-  DEBUG ((DEBUG_INIT, "PCIe: Set link speed\n"));
+  DEBUG ((DEBUG_INIT, "PCIe %u: Set link speed\n", Segment));
   PciSetupLinkSpeed (DbiBase, LinkSpeed, LinkWidth);
   PciDirectSpeedChange (DbiBase);
 
   /* Disallow writing RO registers through the DBI */
   MmioAnd32 (DbiBase + PL_MISC_CONTROL_1_OFF, ~DBI_RO_WR_EN);
 
-  DEBUG ((DEBUG_INIT, "PCIe: Assert reset\n"));
+  DEBUG ((DEBUG_INIT, "PCIe %u: Assert reset\n", Segment));
   PciePeReset (Segment, TRUE);
 
-  DEBUG ((DEBUG_INIT, "PCIe: Start LTSSM\n"));
-
+  DEBUG ((DEBUG_INIT, "PCIe %u: Start LTSSM\n", Segment));
   PciEnableLtssm (ApbBase, TRUE);
 
+  return EFI_SUCCESS;
+}
+
+/**
+  Bring up a set of PCIe controllers.
+
+  The controllers are brought up together, one phase at a time, so that
+  the power-up and PERST# delays and the wait for link up are shared
+  between them rather than added up.
+
+  @param[in]  SegmentMask   Bit mask of the segments to initialize.
+
+  @return Bit mask of the segments whose link came up.
+
+**/
+UINT32
+InitializePciHosts (
+  IN UINT32  SegmentMask
+  )
+{
+  EFI_STATUS              Status;
+  UINT32                  Segment;
+  UINT32                  PendingMask;
+  UINT32                  DetectedMask;
+  UINT32                  EmptyMask;
+  UINT32                  LinkUpMask;
+  UINT32                  LinkSpeed[NUM_SEGMENTS];
+  UINT32                  LinkWidth[NUM_SEGMENTS];
+  UINT64                  StartTime[NUM_SEGMENTS];
+  UINT64                  InitStartTime;
+  UINT64                  LinkStartTime;
+  UINT64                  Now;
+  UINT64                  Deadline;
+  UINT64                  DetectDeadline;
+  PCIE_LINK_STATUS_TABLE  LinkStatusTable;
+
+  InitStartTime = GetPerformanceCounter ();
+
+  ZeroMem (&LinkStatusTable, sizeof (LinkStatusTable));
+  LinkStatusTable.Revision = PCIE_LINK_STATUS_TABLE_REVISION;
+  LinkStatusTable.Count    = NUM_SEGMENTS;
+
+  for (Segment = 0; Segment < NUM_SEGMENTS; Segment++) {
+    if ((SegmentMask & (1 << Segment)) == 0) {
+      continue;
+    }
+
+    Status = PciGetSegmentConfig (Segment, &LinkSpeed[Segment], &LinkWidth[Segment]);
+    if (EFI_ERROR (Status)) {
+      SegmentMask &= ~(1 << Segment);
+      continue;
+    }
+
+    /* Log settings */
+    DEBUG ((DEBUG_INIT, "\nPCIe: Segment %u\n", Segment));
+    DEBUG ((DEBUG_INIT, "PCIe: PciExpressBaseAddress 0x%lx\n", PCIE_CFG_BASE (Segment)));
+    DEBUG ((DEBUG_INIT, "PCIe: ApbBase 0x%lx\n", PCIE_APB_BASE (Segment)));
+    DEBUG ((DEBUG_INIT, "PCIe: DbiBase 0x%lx\n", PCIE_DBI_BASE (Segment)));
+    DEBUG ((DEBUG_INIT, "PCIe: NumLanes %u\n", LinkWidth[Segment]));
+    DEBUG ((DEBUG_INIT, "PCIe: LinkSpeed %u\n", LinkSpeed[Segment]));
+  }
+
+  if (SegmentMask == 0) {
+    return 0;
+  }
+
+  /* Phase 1: power up all the slots */
+  for (Segment = 0; Segment < NUM_SEGMENTS; Segment++) {
+    if ((SegmentMask & (1 << Segment)) == 0) {
+      continue;
+    }
+
+    LinkStatusTable.Links[Segment].Flags = PCIE_LINK_STATUS_ENABLED;
+
+    StartTime[Segment] = GetPerformanceCounter ();
+    PcieIoInit (Segment);
+    PciePowerEn (Segment, TRUE);
+  }
+
   gBS->Stall (100000);
-  DEBUG ((DEBUG_INIT, "PCIe: Deassert reset\n"));
-  PciePeReset (Segment, FALSE);
 
-  /* Wait for link up */
+  /* Phase 2: configure the controllers and start link training */
+  for (Segment = 0; Segment < NUM_SEGMENTS; Segment++) {
+    if ((SegmentMask & (1 << Segment)) == 0) {
+      continue;
+    }
+
+    Status = PciSetupController (Segment, LinkSpeed[Segment], LinkWidth[Segment]);
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_WARN, "PCIe %u: Setup failed: %r\n", Segment, Status));
+      SegmentMask &= ~(1 << Segment);
+    }
+  }
+
+  if (SegmentMask == 0) {
+    return 0;
+  }
+
+  /* Phase 3: release PERST# */
+  gBS->Stall (FixedPcdGet32 (PcdPciePerstDelayUs));
+
+  for (Segment = 0; Segment < NUM_SEGMENTS; Segment++) {
+    if ((SegmentMask & (1 << Segment)) == 0) {
+      continue;
+    }
+
+    DEBUG ((DEBUG_INIT, "PCIe %u: Deassert reset\n", Segment));
+    PciePeReset (Segment, FALSE);
+  }
+
+  /* Phase 4: wait for all the links to come up, with a shared deadline */
   DEBUG ((DEBUG_INIT, "PCIe: Waiting for link up...\n"));
-  for (Retry = 10; Retry != 0; Retry--) {
-    if (PciIsLinkUp (ApbBase)) {
+  PendingMask    = SegmentMask;
+  DetectedMask   = 0;
+  EmptyMask      = 0;
+  LinkUpMask     = 0;
+  LinkStartTime  = GetPerformanceCounter ();
+  Deadline       = GetTimeInNanoSecond (LinkStartTime) +
+                   MultU64x32 (FixedPcdGet32 (PcdPcieLinkUpTimeoutMs), 1000000);
+  DetectDeadline = GetTimeInNanoSecond (LinkStartTime) +
+                   MultU64x32 (FixedPcdGet32 (PcdPcieLinkDetectTimeoutMs), 1000000);
+
+  while (PendingMask != 0) {
+    for (Segment = 0; Segment < NUM_SEGMENTS; Segment++) {
+      if ((PendingMask & (1 << Segment)) == 0) {
+        continue;
+      }
+
+      if (PciIsLinkUp (Segment, PCIE_APB_BASE (Segment))) {
+        PendingMask &= ~(1 << Segment);
+        LinkUpMask  |= 1 << Segment;
+        DEBUG ((
+          DEBUG_INIT,
+          "PCIe %u: Link up after %lu ms (%lu ms since power on)\n",
+          Segment,
+          PciGetElapsedMs (LinkStartTime),
+          PciGetElapsedMs (StartTime[Segment])
+          ));
+      } else if (PciIsReceiverDetected (PCIE_APB_BASE (Segment))) {
+        DetectedMask |= 1 << Segment;
+      }
+    }
+
+    Now = GetTimeInNanoSecond (GetPerformanceCounter ());
+
+    //
+    // Stop waiting for the slots where no receiver has shown up within the
+    // detect window, there's nothing plugged into them.
+    //
+    if ((FixedPcdGet32 (PcdPcieLinkDetectTimeoutMs) != 0) && (Now > DetectDeadline)) {
+      for (Segment = 0; Segment < NUM_SEGMENTS; Segment++) {
+        if ((PendingMask & ~DetectedMask & (1 << Segment)) == 0) {
+          continue;
+        }
+
+        PendingMask &= ~(1 << Segment);
+        EmptyMask   |= 1 << Segment;
+
+        DEBUG ((
+          DEBUG_INIT,
+          "PCIe %u: No device detected after %lu ms, powering slot off\n",
+          Segment,
+          PciGetElapsedMs (LinkStartTime)
+          ));
+        PciPowerOffSlot (Segment);
+      }
+    }
+
+    if ((PendingMask == 0) || (Now > Deadline)) {
       break;
     }
 
-    gBS->Stall (100000);
+    gBS->Stall (PCIE_LINK_UP_POLL_INTERVAL_US);
   }
 
-  if (Retry == 0) {
-    DEBUG ((DEBUG_WARN, "PCIe: Link up timeout!\n"));
-    return EFI_TIMEOUT;
+  for (Segment = 0; Segment < NUM_SEGMENTS; Segment++) {
+    if ((PendingMask & (1 << Segment)) != 0) {
+      DEBUG ((
+        DEBUG_WARN,
+        "PCIe %u: Link up timeout! (%lu ms since power on)\n",
+        Segment,
+        PciGetElapsedMs (StartTime[Segment])
+        ));
+      continue;
+    }
+
+    if ((LinkUpMask & (1 << Segment)) == 0) {
+      continue;
+    }
+
+    LinkStatusTable.Links[Segment].Flags |= PCIE_LINK_STATUS_LINK_UP;
+
+    /* CFG0 window as set up by PciSetupController() */
+    PciValidateCfg0 (Segment, PCIE_CFG_BASE (Segment) + SIZE_1MB);
+
+    PciVerifyLink (Segment, LinkSpeed[Segment], LinkWidth[Segment], &LinkStatusTable.Links[Segment]);
+
+    PciGetLinkSpeedWidth (PCIE_DBI_BASE (Segment), &LinkSpeed[Segment], &LinkWidth[Segment]);
+    PciPrintLinkSpeedWidth (Segment, LinkSpeed[Segment], LinkWidth[Segment]);
   }
 
-  PciGetLinkSpeedWidth (DbiBase, &LinkSpeed, &LinkWidth);
-  PciPrintLinkSpeedWidth (LinkSpeed, LinkWidth);
+  PciPublishLinkStatus (&LinkStatusTable);
 
-  PciValidateCfg0 (Segment, PcieBase + Cfg0Base);
+  DEBUG ((
+    DEBUG_INIT,
+    "PCIe: Segments 0x%x initialized in %lu ms, links up: 0x%x, empty slots skipped: 0x%x\n",
+    SegmentMask,
+    PciGetElapsedMs (InitStartTime),
+    LinkUpMask,
+    EmptyMask
+    ));
 
-  return EFI_SUCCESS;
+  return LinkUpMask;
 }
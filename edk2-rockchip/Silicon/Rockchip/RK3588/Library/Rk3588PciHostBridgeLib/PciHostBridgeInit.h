@@ -10,9 +10,9 @@
 #ifndef PCIHOSTBRIDGEINIT_H__
 #define PCIHOSTBRIDGEINIT_H__
 
-EFI_STATUS
-InitializePciHost (
-  UINT32  Segment
+UINT32
+InitializePciHosts (
+  IN UINT32  SegmentMask
   );
 
 #endif /* PCIHOSTBRIDGEINIT_H__ */
@@ -15,9 +15,12 @@
 #include <Library/MemoryAllocationLib.h>
 #include <Library/PcdLib.h>
 #include <Library/Rk3588Pcie.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/UefiLib.h>
 
 #include <Protocol/PciRootBridgeIo.h>
 #include <Protocol/PciHostBridgeResourceAllocation.h>
+#include <Protocol/PciEnumerationComplete.h>
 
 #include "PciHostBridgeInit.h"
 
@@ -148,6 +151,44 @@ CHAR16  *mPciHostBridgeLibAcpiAddressSpaceTypeStr[] = {
 
 PCI_ROOT_BRIDGE  mPciRootBridges[NUM_PCIE_CONTROLLER];
 
+STATIC VOID  *mPciEnumerationCompleteRegistration;
+
+/**
+  Report the number of config space accesses made during enumeration.
+
+  @param[in]  Event     Event whose notification function is being invoked.
+  @param[in]  Context   Pointer to the notification function's context.
+
+**/
+STATIC
+VOID
+EFIAPI
+OnPciEnumerationComplete (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  EFI_STATUS  Status;
+  VOID        *Interface;
+
+  Status = gBS->LocateProtocol (
+                  &gEfiPciEnumerationCompleteProtocolGuid,
+                  mPciEnumerationCompleteRegistration,
+                  &Interface
+                  );
+  if (EFI_ERROR (Status)) {
+    return;
+  }
+
+  gBS->CloseEvent (Event);
+
+  DEBUG ((
+    DEBUG_INFO,
+    "PciHostBridge: %llu config space accesses during enumeration\n",
+    PciSegmentLibGetConfigAccessCount (TRUE)
+    ));
+}
+
 /**
   Return all the root bridge instances in an array.
 
@@ -163,17 +204,22 @@ PciHostBridgeGetRootBridges (
   UINTN  *Count
   )
 {
-  EFI_STATUS  Status;
-  UINTN       Idx;
-  UINTN       Loop;
+  UINTN   Idx;
+  UINTN   Loop;
+  UINT32  SegmentMask;
+  UINT32  LinkUpMask;
 
-  for (Idx = 0, Loop = 0; Idx < NUM_PCIE_CONTROLLER; Idx++) {
-    if (IsPcieNumEnabled (Idx) == FALSE) {
-      continue;
+  SegmentMask = 0;
+  for (Idx = 0; Idx < NUM_PCIE_CONTROLLER; Idx++) {
+    if (IsPcieNumEnabled (Idx)) {
+      SegmentMask |= 1 << Idx;
     }
+  }
+
+  LinkUpMask = InitializePciHosts (SegmentMask);
 
-    Status = InitializePciHost (Idx);
-    if (EFI_ERROR (Status)) {
+  for (Idx = 0, Loop = 0; Idx < NUM_PCIE_CONTROLLER; Idx++) {
+    if ((LinkUpMask & (1 << Idx)) == 0) {
       continue;
     }
 
@@ -220,6 +266,15 @@ PciHostBridgeGetRootBridges (
     return NULL;
   }
 
+  PciSegmentLibGetConfigAccessCount (TRUE);
+  EfiCreateProtocolNotifyEvent (
+    &gEfiPciEnumerationCompleteProtocolGuid,
+    TPL_CALLBACK,
+    OnPciEnumerationComplete,
+    NULL,
+    &mPciEnumerationCompleteRegistration
+    );
+
   return mPciRootBridges;
 }
 
@@ -42,6 +42,41 @@ typedef enum {
 #define GET_FUNC_NUM(Address)  ((Address >> 12) & 0x07)
 #define GET_REG_NUM(Address)   ((Address) & 0xFFF)
 
+//
+// Number of configuration register accesses, see
+// PciSegmentLibGetConfigAccessCount(). This is the only global state kept
+// by the library: config bases are decoded from the address on every call,
+// so nothing holds a physical address across SetVirtualAddressMap().
+// Runtime config access itself remains unsupported, as reported by
+// PciSegmentRegisterForRuntimeAccess().
+//
+STATIC UINT64  mConfigAccessCount;
+
+/**
+  Return the number of PCI configuration register accesses made through
+  this library so far, and optionally reset the count.
+
+  @param  Reset   Whether to reset the count to zero.
+
+  @return The number of accesses made since the last reset.
+
+**/
+UINT64
+EFIAPI
+PciSegmentLibGetConfigAccessCount (
+  IN BOOLEAN  Reset
+  )
+{
+  UINT64  Count;
+
+  Count = mConfigAccessCount;
+  if (Reset) {
+    mConfigAccessCount = 0;
+  }
+
+  return Count;
+}
+
 STATIC
 UINT64
 PciSegmentLibGetConfigBase (
@@ -94,6 +129,8 @@ PciSegmentLibReadWorker (
 {
   UINT64  Base;
 
+  mConfigAccessCount++;
+
   Base = PciSegmentLibGetConfigBase (Address);
 
   if (Base == 0xFFFFFFFF) {
@@ -138,6 +175,8 @@ PciSegmentLibWriteWorker (
 {
   UINT64  Base;
 
+  mConfigAccessCount++;
+
   Base = PciSegmentLibGetConfigBase (Address);
 
   if (Base == 0xFFFFFFFF) {
@@ -1251,7 +1290,9 @@ PciSegmentReadBuffer (
   OUT VOID    *Buffer
   )
 {
-  UINTN  ReturnValue;
+  UINTN   ReturnValue;
+  UINT64  Base;
+  UINTN   Index;
 
   ASSERT_INVALID_PCI_SEGMENT_ADDRESS (StartAddress, 0);
   ASSERT (((StartAddress & 0xFFF) + Size) <= 0x1000);
@@ -1267,51 +1308,72 @@ PciSegmentReadBuffer (
   //
   ReturnValue = Size;
 
-  if ((StartAddress & BIT0) != 0) {
+  //
+  // The whole range belongs to a single function, so resolve its config
+  // base once and access the registers directly.
+  //
+  Base = PciSegmentLibGetConfigBase (StartAddress);
+  if (Base == 0xFFFFFFFF) {
+    mConfigAccessCount++;
+    for (Index = 0; Index < Size; Index++) {
+      ((UINT8 *)Buffer)[Index] = 0xFF;
+    }
+
+    return ReturnValue;
+  }
+
+  Base += (UINT32)StartAddress;
+
+  if ((Base & BIT0) != 0) {
     //
     // Read a byte if StartAddress is byte aligned
     //
-    *(volatile UINT8 *)Buffer = PciSegmentRead8 (StartAddress);
-    StartAddress             += sizeof (UINT8);
+    *(volatile UINT8 *)Buffer = MmioRead8 (Base);
+    Base                     += sizeof (UINT8);
     Size                     -= sizeof (UINT8);
     Buffer                    = (UINT8 *)Buffer + 1;
+    mConfigAccessCount++;
   }
 
-  if ((Size >= sizeof (UINT16)) && ((StartAddress & BIT1) != 0)) {
+  if ((Size >= sizeof (UINT16)) && ((Base & BIT1) != 0)) {
     //
     // Read a word if StartAddress is word aligned
     //
-    WriteUnaligned16 (Buffer, PciSegmentRead16 (StartAddress));
-    StartAddress += sizeof (UINT16);
-    Size         -= sizeof (UINT16);
-    Buffer        = (UINT16 *)Buffer + 1;
+    WriteUnaligned16 (Buffer, MmioRead16 (Base));
+    Base   += sizeof (UINT16);
+    Size   -= sizeof (UINT16);
+    Buffer  = (UINT16 *)Buffer + 1;
+    mConfigAccessCount++;
   }
 
   while (Size >= sizeof (UINT32)) {
     //
     // Read as many double words as possible
     //
-    WriteUnaligned32 (Buffer, PciSegmentRead32 (StartAddress));
-    StartAddress += sizeof (UINT32);
-    Size         -= sizeof (UINT32);
-    Buffer        = (UINT32 *)Buffer + 1;
+    WriteUnaligned32 (Buffer, MmioRead32 (Base));
+    Base   += sizeof (UINT32);
+    Size   -= sizeof (UINT32);
+    Buffer  = (UINT32 *)Buffer + 1;
+    mConfigAccessCount++;
   }
 
   if (Size >= sizeof (UINT16)) {
     //
     // Read the last remaining word if exist
     //
-    WriteUnaligned16 (Buffer, PciSegmentRead16 (StartAddress));
-    StartAddress += sizeof (UINT16);
-    Size         -= sizeof (UINT16);
-    Buffer        = (UINT16 *)Buffer + 1;
+    WriteUnaligned16 (Buffer, MmioRead16 (Base));
+    Base   += sizeof (UINT16);
+    Size   -= sizeof (UINT16);
+    Buffer  = (UINT16 *)Buffer + 1;
+    mConfigAccessCount++;
   }
 
   if (Size >= sizeof (UINT8)) {
     //
     // Read the last remaining byte if exist
     //
-    *(volatile UINT8 *)Buffer = PciSegmentRead8 (StartAddress);
+    *(volatile UINT8 *)Buffer = MmioRead8 (Base);
+    mConfigAccessCount++;
   }
 
   return ReturnValue;
@@ -1349,7 +1411,8 @@ PciSegmentWriteBuffer (
   IN VOID    *Buffer
   )
 {
-  UINTN  ReturnValue;
+  UINTN   ReturnValue;
+  UINT64  Base;
 
   ASSERT_INVALID_PCI_SEGMENT_ADDRESS (StartAddress, 0);
   ASSERT (((StartAddress & 0xFFF) + Size) <= 0x1000);
@@ -1365,51 +1428,68 @@ PciSegmentWriteBuffer (
   //
   ReturnValue = Size;
 
-  if ((StartAddress & BIT0) != 0) {
+  //
+  // The whole range belongs to a single function, so resolve its config
+  // base once and access the registers directly.
+  //
+  Base = PciSegmentLibGetConfigBase (StartAddress);
+  if (Base == 0xFFFFFFFF) {
+    mConfigAccessCount++;
+    return ReturnValue;
+  }
+
+  Base += (UINT32)StartAddress;
+
+  if ((Base & BIT0) != 0) {
     //
     // Write a byte if StartAddress is byte aligned
     //
-    PciSegmentWrite8 (StartAddress, *(UINT8 *)Buffer);
-    StartAddress += sizeof (UINT8);
-    Size         -= sizeof (UINT8);
-    Buffer        = (UINT8 *)Buffer + 1;
+    MmioWrite8 (Base, *(UINT8 *)Buffer);
+    Base   += sizeof (UINT8);
+    Size   -= sizeof (UINT8);
+    Buffer  = (UINT8 *)Buffer + 1;
+    mConfigAccessCount++;
   }
 
-  if ((Size >= sizeof (UINT16)) && ((StartAddress & BIT1) != 0)) {
+  if ((Size >= sizeof (UINT16)) && ((Base & BIT1) != 0)) {
     //
     // Write a word if StartAddress is word aligned
     //
-    PciSegmentWrite16 (StartAddress, ReadUnaligned16 (Buffer));
-    StartAddress += sizeof (UINT16);
-    Size         -= sizeof (UINT16);
-    Buffer        = (UINT16 *)Buffer + 1;
+    MmioWrite16 (Base, ReadUnaligned16 (Buffer));
+    Base   += sizeof (UINT16);
+    Size   -= sizeof (UINT16);
+    Buffer  = (UINT16 *)Buffer + 1;
+    mConfigAccessCount++;
   }
 
   while (Size >= sizeof (UINT32)) {
     //
     // Write as many double words as possible
     //
-    PciSegmentWrite32 (StartAddress, ReadUnaligned32 (Buffer));
-    StartAddress += sizeof (UINT32);
-    Size         -= sizeof (UINT32);
-    Buffer        = (UINT32 *)Buffer + 1;
+    MmioWrite32 (Base, ReadUnaligned32 (Buffer));
+    Base   += sizeof (UINT32);
+    Size   -= sizeof (UINT32);
+    Buffer  = (UINT32 *)Buffer + 1;
+    mConfigAccessCount++;
   }
 
   if (Size >= sizeof (UINT16)) {
     //
     // Write the last remaining word if exist
     //
-    PciSegmentWrite16 (StartAddress, ReadUnaligned16 (Buffer));
-    StartAddress += sizeof (UINT16);
-    Size         -= sizeof (UINT16);
-    Buffer        = (UINT16 *)Buffer + 1;
+    MmioWrite16 (Base, ReadUnaligned16 (Buffer));
+    Base   += sizeof (UINT16);
+    Size   -= sizeof (UINT16);
+    Buffer  = (UINT16 *)Buffer + 1;
+    mConfigAccessCount++;
   }
 
   if (Size >= sizeof (UINT8)) {
     //
     // Write the last remaining byte if exist
     //
-    PciSegmentWrite8 (StartAddress, *(UINT8 *)Buffer);
+    MmioWrite8 (Base, *(UINT8 *)Buffer);
+    mConfigAccessCount++;
   }
 
   return ReturnValue;
@@ -10,6 +10,7 @@
 
 #include <Uefi.h>
 #include <Library/RkSdmmcPlatformLib.h>
+#include <Library/BaseLib.h>
 #include <Library/DebugLib.h>
 #include <Library/UefiBootServicesTableLib.h>
 #include <Library/GpioLib.h>
@@ -19,6 +20,23 @@
 
 #define SCMI_CCLK_SD  9
 
+#define CRU_SDMMC_CON0  (0xFD7C0000 + 0x0C30)
+#define CRU_SDMMC_CON1  (0xFD7C0000 + 0x0C34)
+
+//
+// MMC phase clock generator: the drive/sample clocks run at half the
+// cclk_sdmmc rate and can be shifted in 90 degree steps, plus a fine
+// delay line of up to 255 elements of roughly 60 ps each.
+//
+#define MMC_CLKGEN_DIV          2
+#define MMC_DELAY_ELEMENT_PSEC  60
+#define MMC_DELAY_SEL           BIT10
+#define MMC_DELAYNUM_SHIFT      2
+#define MMC_PHASE_SHIFT         1
+#define MMC_PHASE_MASK          0x07FF
+
+STATIC UINTN  mSdmmcClockRate;
+
 EFI_STATUS
 EFIAPI
 RkSdmmcSetClockRate (
@@ -39,6 +57,10 @@ RkSdmmcSetClockRate (
   Status = ClockProtocol->RateSet (ClockProtocol, SCMI_CCLK_SD, Frequency);
   ASSERT (!EFI_ERROR (Status));
 
+  if (!EFI_ERROR (Status)) {
+    mSdmmcClockRate = Frequency;
+  }
+
   return Status;
 }
 
@@ -66,3 +88,51 @@ RkSdmmcGetCardPresenceState (
   return GpioPinReadActual (0, GPIO_PIN_PA4) ? RkSdmmcCardNotPresent
                                              : RkSdmmcCardPresent;
 }
+
+EFI_STATUS
+EFIAPI
+RkSdmmcSetClockPhase (
+  IN RKSDMMC_CLOCK_PHASE_TYPE  Type,
+  IN UINT32                    Degrees
+  )
+{
+  UINT32  Nineties;
+  UINT32  Remainder;
+  UINT64  Delay;
+  UINT32  DelayNum;
+  UINT32  Value;
+  UINTN   Rate;
+
+  Rate = mSdmmcClockRate / MMC_CLKGEN_DIV;
+  if (Rate < 1000) {
+    return EFI_NOT_READY;
+  }
+
+  Degrees  %= 360;
+  Nineties  = Degrees / 90;
+  Remainder = Degrees % 90;
+
+  //
+  // Convert the remainder into delay elements:
+  // delay = (Remainder / 360) * period / element
+  //
+  Delay    = DivU64x64Remainder (
+               MultU64x32 (10000000, Remainder),
+               (UINT64)(Rate / 1000) * 36 * (MMC_DELAY_ELEMENT_PSEC / 10),
+               NULL
+               );
+  DelayNum = (UINT32)MIN (Delay, 255);
+
+  Value  = Nineties;
+  Value |= DelayNum << MMC_DELAYNUM_SHIFT;
+  if (DelayNum != 0) {
+    Value |= MMC_DELAY_SEL;
+  }
+
+  MmioWrite32 (
+    (Type == RkSdmmcSamplePhase) ? CRU_SDMMC_CON1 : CRU_SDMMC_CON0,
+    ((MMC_PHASE_MASK << MMC_PHASE_SHIFT) << 16) | (Value << MMC_PHASE_SHIFT)
+    );
+
+  return EFI_SUCCESS;
+}
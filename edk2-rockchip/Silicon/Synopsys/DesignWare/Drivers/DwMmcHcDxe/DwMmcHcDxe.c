@@ -161,19 +161,20 @@ ProcessAsyncTaskList (
   Private = (DW_MMC_HC_PRIVATE_DATA *)Context;
 
   //
-  // Check if the first entry in the async I/O queue is done or not.
+  // Check if the first entry in the async I/O queue is done or not. Once it
+  // completes, start the next one right away instead of waiting for another
+  // timer tick, so queued requests keep the controller busy.
   //
-  Status = EFI_SUCCESS;
-  Trb    = NULL;
-  Link   = GetFirstNode (&Private->Queue);
-  if (!IsNull (&Private->Queue, Link)) {
+  for ( ; ;) {
+    Link = GetFirstNode (&Private->Queue);
+    if (IsNull (&Private->Queue, Link)) {
+      return;
+    }
+
     Trb = DW_MMC_HC_TRB_FROM_THIS (Link);
     if (!Private->Slot[Trb->Slot].MediaPresent) {
       Status = EFI_NO_MEDIA;
-      goto Done;
-    }
-
-    if (!Trb->Started) {
+    } else if (!Trb->Started) {
       //
       // Check whether the cmd/data line is ready for transfer.
       //
@@ -181,42 +182,29 @@ ProcessAsyncTaskList (
       if (!EFI_ERROR (Status)) {
         Trb->Started = TRUE;
         Status       = DwMmcExecTrb (Private, Trb);
-        if (EFI_ERROR (Status)) {
-          goto Done;
+        if (!EFI_ERROR (Status)) {
+          Status = DwMmcCheckTrbResult (Private, Trb);
         }
-      } else {
-        goto Done;
       }
+    } else {
+      Status = DwMmcCheckTrbResult (Private, Trb);
     }
 
-    Status = DwMmcCheckTrbResult (Private, Trb);
-  }
+    if (Status == EFI_NOT_READY) {
+      Packet = Trb->Packet;
+      if (Packet->Timeout == 0) {
+        InfiniteWait = TRUE;
+      } else {
+        InfiniteWait = FALSE;
+      }
 
-Done:
-  if ((Trb != NULL) && (Status == EFI_NOT_READY)) {
-    Packet = Trb->Packet;
-    if (Packet->Timeout == 0) {
-      InfiniteWait = TRUE;
-    } else {
-      InfiniteWait = FALSE;
-    }
+      if (InfiniteWait || (Trb->Timeout-- != 0)) {
+        return;
+      }
 
-    if ((!InfiniteWait) && (Trb->Timeout-- == 0)) {
-      RemoveEntryList (Link);
-      Trb->Packet->TransactionStatus = EFI_TIMEOUT;
-      TrbEvent                       = Trb->Event;
-      DwMmcFreeTrb (Trb);
-      DEBUG ((
-        DEBUG_VERBOSE,
-        "ProcessAsyncTaskList(): Signal Event %p EFI_TIMEOUT\n",
-        TrbEvent
-        ));
-      gBS->SignalEvent (TrbEvent);
-      return;
+      Status = EFI_TIMEOUT;
     }
-  }
 
-  if ((Trb != NULL) && (Status != EFI_NOT_READY)) {
     RemoveEntryList (Link);
     Trb->Packet->TransactionStatus = Status;
     TrbEvent                       = Trb->Event;
@@ -229,8 +217,6 @@ Done:
       ));
     gBS->SignalEvent (TrbEvent);
   }
-
-  return;
 }
 
 /**
@@ -649,6 +635,11 @@ DwMmcHcDriverBindingStart (
   Private->PlatformDwMmc    = PlatformDwMmc;
   InitializeListHead (&Private->Queue);
 
+  Status = DwMmcHcAllocDmaDescPool (Private);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_WARN, "%a: No IDMAC descriptor pool: %r\n", __FUNCTION__, Status));
+  }
+
   Status = Private->PlatformDwMmc->GetCapability (Controller, 0, &Private->Capability[0]);
 
   if (EFI_ERROR (Status)) {
@@ -752,6 +743,7 @@ Done:
     }
 
     if (Private != NULL) {
+      DwMmcHcFreeDmaDescPool (Private);
       FreePool (Private);
     }
   }
@@ -871,6 +863,7 @@ DwMmcHcDriverBindingStop (
          Controller
          );
 
+  DwMmcHcFreeDmaDescPool (Private);
   FreePool (Private);
 
   DEBUG ((DEBUG_INFO, "DwMmcHcDriverBindingStop: End with %r\n", Status));
@@ -87,6 +87,20 @@ typedef struct {
   UINT64                           MaxCurrent[DW_MMC_HC_MAX_SLOT];
 
   UINT32                           ControllerVersion;
+  //
+  // Pre-mapped IDMAC descriptor table, reused by the TRBs of this controller.
+  //
+  DW_MMC_HC_DMA_DESC_LINE          *DmaDescPool;
+  EFI_PHYSICAL_ADDRESS             DmaDescPoolPhy;
+  VOID                             *DmaDescPoolMap;
+  BOOLEAN                          DmaDescPoolBusy;
+  //
+  // Descriptor table statistics: tables built, tables that had to be
+  // allocated and mapped on the fly, and total build time in nanoseconds.
+  //
+  UINT64                           DmaDescBuilds;
+  UINT64                           DmaDescAllocations;
+  UINT64                           DmaDescBuildTime;
 } DW_MMC_HC_PRIVATE_DATA;
 
 #define DW_MMC_HC_TRB_SIG  SIGNATURE_32 ('D', 'T', 'R', 'B')
@@ -120,6 +134,8 @@ typedef struct {
 
   BOOLEAN                                UseFifo;
   BOOLEAN                                UseBE;               // Big-endian
+  BOOLEAN                                CmdIssued;           // IDMAC transfer in flight
+  BOOLEAN                                AutoStop;            // CMD12 sent by the controller after the data
 
   DW_MMC_HC_PRIVATE_DATA                 *Private;
 } DW_MMC_HC_TRB;
@@ -660,6 +676,32 @@ DwMmcHcComponentNameGetControllerName (
   OUT CHAR16                          **ControllerName
   );
 
+/**
+  Allocate and map the IDMAC descriptor pool of the controller.
+
+  @param[in] Private        A pointer to the DW_MMC_HC_PRIVATE_DATA instance.
+
+  @retval EFI_SUCCESS       The descriptor pool is ready.
+  @retval Others            The pool isn't available, descriptor tables will
+                            be allocated per transfer.
+
+**/
+EFI_STATUS
+DwMmcHcAllocDmaDescPool (
+  IN DW_MMC_HC_PRIVATE_DATA  *Private
+  );
+
+/**
+  Unmap and free the IDMAC descriptor pool of the controller.
+
+  @param[in] Private        A pointer to the DW_MMC_HC_PRIVATE_DATA instance.
+
+**/
+VOID
+DwMmcHcFreeDmaDescPool (
+  IN DW_MMC_HC_PRIVATE_DATA  *Private
+  );
+
 /**
   Create a new TRB for the SD/MMC cmd request.
 
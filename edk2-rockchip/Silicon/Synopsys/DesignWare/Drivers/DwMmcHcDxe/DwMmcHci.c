@@ -18,6 +18,7 @@
 #include <Library/IoLib.h>
 #include <Library/DebugLib.h>
 #include <Library/MemoryAllocationLib.h>
+#include <Library/TimerLib.h>
 #include <Library/UefiBootServicesTableLib.h>
 
 #include "DwMmcHcDxe.h"
@@ -661,6 +662,191 @@ DwMmcHcStopDma (
   return EFI_SUCCESS;
 }
 
+/**
+  Allocate and map the IDMAC descriptor pool of the controller.
+
+  @param[in] Private        A pointer to the DW_MMC_HC_PRIVATE_DATA instance.
+
+  @retval EFI_SUCCESS       The descriptor pool is ready.
+  @retval Others            The pool isn't available, descriptor tables will
+                            be allocated per transfer.
+
+**/
+EFI_STATUS
+DwMmcHcAllocDmaDescPool (
+  IN DW_MMC_HC_PRIVATE_DATA  *Private
+  )
+{
+  EFI_STATUS  Status;
+  VOID        *Pool;
+  UINTN       Bytes;
+
+  Status = DmaAllocateBuffer (EfiBootServicesData, DWMMC_DMA_POOL_PAGES, &Pool);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Bytes  = EFI_PAGES_TO_SIZE (DWMMC_DMA_POOL_PAGES);
+  Status = DmaMap (
+             MapOperationBusMasterCommonBuffer,
+             Pool,
+             &Bytes,
+             &Private->DmaDescPoolPhy,
+             &Private->DmaDescPoolMap
+             );
+  if (EFI_ERROR (Status) ||
+      (Bytes != EFI_PAGES_TO_SIZE (DWMMC_DMA_POOL_PAGES)) ||
+      ((Private->DmaDescPoolPhy + Bytes) > 0x100000000ul))
+  {
+    //
+    // The IDMAC only supports a 32-bit descriptor table.
+    //
+    if (!EFI_ERROR (Status)) {
+      DmaUnmap (Private->DmaDescPoolMap);
+      Status = EFI_UNSUPPORTED;
+    }
+
+    DmaFreeBuffer (DWMMC_DMA_POOL_PAGES, Pool);
+    Private->DmaDescPoolMap = NULL;
+    return Status;
+  }
+
+  ZeroMem (Pool, Bytes);
+  Private->DmaDescPool     = Pool;
+  Private->DmaDescPoolBusy = FALSE;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Unmap and free the IDMAC descriptor pool of the controller.
+
+  @param[in] Private        A pointer to the DW_MMC_HC_PRIVATE_DATA instance.
+
+**/
+VOID
+DwMmcHcFreeDmaDescPool (
+  IN DW_MMC_HC_PRIVATE_DATA  *Private
+  )
+{
+  if (Private->DmaDescPool == NULL) {
+    return;
+  }
+
+  DEBUG ((
+    DEBUG_INFO,
+    "%a: %Lu descriptor tables built, %Lu allocated, %Lu ns\n",
+    __FUNCTION__,
+    Private->DmaDescBuilds,
+    Private->DmaDescAllocations,
+    Private->DmaDescBuildTime
+    ));
+
+  DmaUnmap (Private->DmaDescPoolMap);
+  DmaFreeBuffer (DWMMC_DMA_POOL_PAGES, Private->DmaDescPool);
+  Private->DmaDescPool    = NULL;
+  Private->DmaDescPoolMap = NULL;
+}
+
+/**
+  Allocate and map a descriptor table for a transfer that can't use the
+  descriptor pool of the controller.
+
+  @param[in] Trb            The pointer to the DW_MMC_HC_TRB instance.
+  @param[in] TableSize      Size of the descriptor table in bytes.
+
+  @retval EFI_SUCCESS       The DMA descriptor table is allocated.
+  @retval Others            The DMA descriptor table isn't allocated.
+
+**/
+STATIC
+EFI_STATUS
+AllocDmaDescTable (
+  IN DW_MMC_HC_TRB  *Trb,
+  IN UINTN          TableSize
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       Bytes;
+
+  Trb->DmaDescPages = (UINT32)EFI_SIZE_TO_PAGES (TableSize);
+  Status            = DmaAllocateBuffer (
+                        EfiBootServicesData,
+                        Trb->DmaDescPages,
+                        (VOID *)&Trb->DmaDesc
+                        );
+  if (EFI_ERROR (Status)) {
+    Trb->DmaDesc = NULL;
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  ZeroMem (Trb->DmaDesc, TableSize);
+  Bytes = TableSize;
+
+  Status = DmaMap (
+             MapOperationBusMasterCommonBuffer,
+             Trb->DmaDesc,
+             &Bytes,
+             &Trb->DmaDescPhy,
+             &Trb->DmaMap
+             );
+  if (EFI_ERROR (Status) || (Bytes != TableSize) ||
+      ((Trb->DmaDescPhy + Bytes) > 0x100000000ul))
+  {
+    //
+    // Map error, unable to map the whole table into a contiguous region,
+    // or the DMA doesn't support 64bit addressing.
+    //
+    if (!EFI_ERROR (Status)) {
+      DmaUnmap (Trb->DmaMap);
+    }
+
+    DmaFreeBuffer (Trb->DmaDescPages, Trb->DmaDesc);
+    Trb->DmaDesc = NULL;
+    Trb->DmaMap  = NULL;
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Trb->Private->DmaDescAllocations++;
+  DEBUG ((
+    DEBUG_VERBOSE,
+    "%a: %lu byte table allocated (%Lu so far)\n",
+    __FUNCTION__,
+    (UINT64)TableSize,
+    Trb->Private->DmaDescAllocations
+    ));
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Release the descriptor table used by the TRB, either back to the pool of
+  the controller or to the allocator.
+
+  @param[in] Trb            The pointer to the DW_MMC_HC_TRB instance.
+
+**/
+STATIC
+VOID
+FreeDmaDescTable (
+  IN DW_MMC_HC_TRB  *Trb
+  )
+{
+  if (Trb->DmaDesc == NULL) {
+    return;
+  }
+
+  if (Trb->DmaDesc == Trb->Private->DmaDescPool) {
+    Trb->Private->DmaDescPoolBusy = FALSE;
+  } else {
+    DmaUnmap (Trb->DmaMap);
+    DmaFreeBuffer (Trb->DmaDescPages, Trb->DmaDesc);
+  }
+
+  Trb->DmaDesc = NULL;
+  Trb->DmaMap  = NULL;
+}
+
 /**
   Build DMA descriptor table for transfer.
 
@@ -683,17 +869,20 @@ BuildDmaDescTable (
   UINTN                    TableSize;
   UINTN                    DevBase;
   EFI_STATUS               Status;
-  UINTN                    Bytes;
   UINTN                    Blocks;
   DW_MMC_HC_DMA_DESC_LINE  *DmaDesc;
+  DW_MMC_HC_PRIVATE_DATA   *Private;
   UINT32                   DmaDescPhy;
   UINT32                   Idsts;
   UINT32                   BytCnt;
   UINT32                   BlkSize;
+  UINT64                   StartTick;
 
-  Data    = Trb->DataPhy;
-  DataLen = Trb->DataLen;
-  DevBase = Trb->Private->DevBase;
+  StartTick = GetPerformanceCounter ();
+  Private   = Trb->Private;
+  Data      = Trb->DataPhy;
+  DataLen   = Trb->DataLen;
+  DevBase   = Private->DevBase;
   //
   // Only support 32bit DMA Descriptor Table
   //
@@ -717,69 +906,19 @@ BuildDmaDescTable (
   TableSize = Entries * sizeof (DW_MMC_HC_DMA_DESC_LINE);
   Blocks    = (DataLen + DW_MMC_BLOCK_SIZE - 1) / DW_MMC_BLOCK_SIZE;
 
-  Trb->DmaDescPages = (UINT32)EFI_SIZE_TO_PAGES (Entries * DWMMC_DMA_BUF_SIZE);
-
-  /*  Status = DevIo->AllocateBuffer (
-                      DevIo,
-                      AllocateAnyPages,
-                      EfiBootServicesData,
-                      EFI_SIZE_TO_PAGES (TableSize),
-                      (EFI_PHYSICAL_ADDRESS *)&Trb->DmaDesc
-                      );*/
-  Status = DmaAllocateBuffer (
-             EfiBootServicesData,
-             EFI_SIZE_TO_PAGES (TableSize),
-             (VOID *)&Trb->DmaDesc
-             );
-  if (EFI_ERROR (Status)) {
-    return EFI_OUT_OF_RESOURCES;
-  }
-
-  ZeroMem (Trb->DmaDesc, TableSize);
-  Bytes = TableSize;
-
-  Status = DmaMap (
-             MapOperationBusMasterCommonBuffer,
-             (EFI_PHYSICAL_ADDRESS *)Trb->DmaDesc,
-             &Bytes,
-             &Trb->DmaDescPhy,
-             &Trb->DmaMap
-             );
-
-  /*  Status = DevIo->Map (
-                      DevIo,
-                      EfiBusMasterCommonBuffer,
-                      (EFI_PHYSICAL_ADDRESS *)Trb->DmaDesc,
-                      &Bytes,
-                      &Trb->DmaDescPhy,
-                      &Trb->DmaMap
-                      );*/
-
-  if (EFI_ERROR (Status) || (Bytes != TableSize)) {
-    //
-    // Map error or unable to map the whole RFis buffer into a contiguous
-    // region.
-    //
-
-    /*    DevIo->FreeBuffer (
-                 DevIo,
-                 EFI_SIZE_TO_PAGES (TableSize),
-                 (EFI_PHYSICAL_ADDRESS)Trb->DmaDesc
-                 );*/
-    return EFI_OUT_OF_RESOURCES;
-  }
-
-  if ((UINT64)(UINTN)Trb->DmaDescPhy > 0x100000000ul) {
-    //
-    // The DMA doesn't support 64bit addressing.
-    //
-    DmaUnmap (Trb->DmaMap);
-
-    /*    DevIo->Unmap (
-          DevIo,
-          Trb->DmaMap
-        );*/
-    return EFI_DEVICE_ERROR;
+  if ((Private->DmaDescPool != NULL) && !Private->DmaDescPoolBusy &&
+      (Entries <= DWMMC_DMA_POOL_ENTRIES))
+  {
+    Trb->DmaDesc             = Private->DmaDescPool;
+    Trb->DmaDescPhy          = Private->DmaDescPoolPhy;
+    Trb->DmaDescPages        = 0;
+    Trb->DmaMap              = NULL;
+    Private->DmaDescPoolBusy = TRUE;
+  } else {
+    Status = AllocDmaDescTable (Trb, TableSize);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
   }
 
   if (DataLen < DW_MMC_BLOCK_SIZE) {
@@ -843,7 +982,10 @@ BuildDmaDescTable (
   Idsts = ~0;
   MmioWrite32 (DevBase + DW_MMC_IDSTS, Idsts);
 
-  return Status;
+  Private->DmaDescBuilds++;
+  Private->DmaDescBuildTime += GetTimeInNanoSecond (GetPerformanceCounter () - StartTick);
+
+  return EFI_SUCCESS;
 }
 
 EFI_STATUS
@@ -968,6 +1110,32 @@ Verify:
   return EFI_SUCCESS;
 }
 
+/**
+  Check whether an SD command moves whole blocks of card data.
+
+  @param[in] Packet         A pointer to the SD command data structure.
+
+  @retval TRUE              The command is a block read or write.
+  @retval FALSE             The command is not a block read or write.
+
+**/
+STATIC
+BOOLEAN
+DwSdIsBlockTransfer (
+  IN EFI_SD_MMC_PASS_THRU_COMMAND_PACKET  *Packet
+  )
+{
+  switch (Packet->SdMmcCmdBlk->CommandIndex) {
+    case SD_READ_SINGLE_BLOCK:
+    case SD_READ_MULTIPLE_BLOCK:
+    case SD_WRITE_SINGLE_BLOCK:
+    case SD_WRITE_MULTIPLE_BLOCK:
+      return TRUE;
+    default:
+      return FALSE;
+  }
+}
+
 /**
   Create a new TRB for the SD/MMC cmd request.
 
@@ -1032,7 +1200,8 @@ DwMmcCreateTrb (
       ((Private->Slot[Trb->Slot].CardType == SdCardType) &&
        (Packet->SdMmcCmdBlk->CommandIndex == SD_SEND_TUNING_BLOCK)))
   {
-    Trb->Mode = SdMmcPioMode;
+    Trb->Mode    = SdMmcPioMode;
+    Trb->UseFifo = TRUE;
   } else {
     if (Trb->Read) {
       Flag = EfiBusMasterWrite;
@@ -1040,7 +1209,15 @@ DwMmcCreateTrb (
       Flag = EfiBusMasterRead;
     }
 
-    if (Private->Slot[Trb->Slot].CardType == SdCardType) {
+    //
+    // SD block reads and writes go through the IDMAC, so queued BlockIo2
+    // requests complete from the async timer without a PIO copy. The other
+    // SD data commands only carry a few bytes, the SCR byte swapped, and
+    // stay on the FIFO.
+    //
+    if ((Private->Slot[Trb->Slot].CardType == SdCardType) &&
+        (!DwSdIsBlockTransfer (Packet) || ((Trb->DataLen % DW_MMC_BLOCK_SIZE) != 0)))
+    {
       Trb->UseFifo = TRUE;
     } else {
       Trb->UseFifo = FALSE;
@@ -1061,17 +1238,10 @@ DwMmcCreateTrb (
           goto Error;
         }
 
-        Status = BuildDmaDescTable (Trb);
-        if (EFI_ERROR (Status)) {
-          DmaUnmap (Trb->DataMap);
-          goto Error;
-        }
-
-        Status = DwMmcHcStartDma (Private, Trb);
-        if (EFI_ERROR (Status)) {
-          DmaUnmap (Trb->DataMap);
-          goto Error;
-        }
+        //
+        // The descriptor table is built when the TRB is started, queued
+        // TRBs must not touch the controller.
+        //
       }
     }
   } /* TuningBlock */
@@ -1085,6 +1255,7 @@ DwMmcCreateTrb (
   return Trb;
 
 Error:
+  FreePool (Trb);
   return NULL;
 }
 
@@ -1099,10 +1270,15 @@ DwMmcFreeTrb (
   IN DW_MMC_HC_TRB  *Trb
   )
 {
-  if (Trb->DmaMap != NULL) {
-    DmaUnmap (Trb->DmaMap);
+  //
+  // Abort an IDMAC transfer that is still in flight (timeout, media removal).
+  //
+  if (Trb->CmdIssued) {
+    DwMmcHcStopDma (Trb->Private, Trb);
   }
 
+  FreeDmaDescTable (Trb);
+
   if (Trb->DataMap != NULL) {
     DmaUnmap (Trb->DataMap);
   }
@@ -1184,8 +1360,60 @@ DwMmcWaitTrbEnv (
   return EFI_TIMEOUT;
 }
 
-EFI_STATUS
-DwEmmcExecTrb (
+/**
+  Program the transfer size of a FIFO TRB and reset the FIFO.
+
+  @param[in] Trb            The pointer to the DW_MMC_HC_TRB instance.
+
+**/
+STATIC
+VOID
+DwMmcSetupFifo (
+  IN DW_MMC_HC_TRB  *Trb
+  )
+{
+  EFI_SD_MMC_PASS_THRU_COMMAND_PACKET  *Packet;
+  UINTN                                DevBase;
+  UINT32                               BytCnt;
+  UINT32                               BlkSize;
+  EFI_STATUS                           Status;
+
+  Packet  = Trb->Packet;
+  DevBase = Trb->Private->DevBase;
+
+  BytCnt = Trb->Read ? Packet->InTransferLength : Packet->OutTransferLength;
+  MmioWrite32 (DevBase + DW_MMC_BYTCNT, BytCnt);
+  if (BytCnt > DW_MMC_BLOCK_SIZE) {
+    BlkSize = DW_MMC_BLOCK_SIZE;
+  } else {
+    BlkSize = BytCnt;
+  }
+
+  MmioWrite32 (DevBase + DW_MMC_BLKSIZ, BlkSize);
+
+  if (Trb->DataLen) {
+    Status = DwMmcHcWaitReset (DevBase, DW_MMC_CTRL_FIFO_RESET);
+    if (EFI_ERROR (Status)) {
+      DEBUG ((
+        DEBUG_ERROR,
+        "%a: FIFO reset timed out. CmdIndex=%d\n",
+        __func__,
+        Packet->SdMmcCmdBlk->CommandIndex
+        ));
+    }
+  }
+}
+
+/**
+  Issue the command of the TRB to an eMMC device, without waiting for it.
+
+  @param[in] Private        A pointer to the DW_MMC_HC_PRIVATE_DATA instance.
+  @param[in] Trb            The pointer to the DW_MMC_HC_TRB instance.
+
+**/
+STATIC
+VOID
+DwEmmcSendCmd (
   IN DW_MMC_HC_PRIVATE_DATA  *Private,
   IN DW_MMC_HC_TRB           *Trb
   )
@@ -1196,8 +1424,6 @@ DwEmmcExecTrb (
   UINT32                               MmcStatus;
   UINT32                               IntStatus;
   UINT32                               Argument;
-  UINT32                               ErrMask;
-  UINT32                               Timeout;
 
   Packet  = Trb->Packet;
   DevBase = Trb->Private->DevBase;
@@ -1265,6 +1491,10 @@ DwEmmcExecTrb (
 
   Cmd |= BIT_CMD_USE_HOLD_REG | BIT_CMD_START;
 
+  if (Trb->UseFifo == TRUE) {
+    DwMmcSetupFifo (Trb);
+  }
+
   Argument = Packet->SdMmcCmdBlk->CommandArgument;
   MmioWrite32 (DevBase + DW_MMC_CMDARG, Argument);
 
@@ -1274,31 +1504,25 @@ DwEmmcExecTrb (
   MmioWrite32 (DevBase + DW_MMC_CMD, Cmd);
   ArmDataSynchronizationBarrier ();
   ArmInstructionSynchronizationBarrier ();
+}
 
-  ErrMask = DW_MMC_INT_EBE | DW_MMC_INT_HLE | DW_MMC_INT_RTO |
-            DW_MMC_INT_RCRC | DW_MMC_INT_RE;
-  ErrMask |= DW_MMC_INT_DCRC | DW_MMC_INT_DRT | DW_MMC_INT_SBE;
-  do {
-    Timeout = 10000;
-    if (--Timeout == 0) {
-      break;
-    }
+/**
+  Fetch the response of a completed eMMC command.
 
-    IntStatus = MmioRead32 (DevBase + DW_MMC_RINTSTS);
-    if (IntStatus & ErrMask) {
-      return EFI_DEVICE_ERROR;
-    }
+  @param[in] Trb            The pointer to the DW_MMC_HC_TRB instance.
 
-    if (Trb->DataLen && ((IntStatus & DW_MMC_INT_DTO) == 0)) {
-      //
-      // Transfer Not Done
-      //
-      MicroSecondDelay (10);
-      continue;
-    }
+**/
+STATIC
+VOID
+DwEmmcGetResponse (
+  IN DW_MMC_HC_TRB  *Trb
+  )
+{
+  EFI_SD_MMC_PASS_THRU_COMMAND_PACKET  *Packet;
+  UINTN                                DevBase;
 
-    MicroSecondDelay (10);
-  } while (!(IntStatus & DW_MMC_INT_CMD_DONE));
+  Packet  = Trb->Packet;
+  DevBase = Trb->Private->DevBase;
 
   switch (Packet->SdMmcCmdBlk->ResponseType) {
     case SdMmcResponseTypeR1:
@@ -1335,12 +1559,67 @@ DwEmmcExecTrb (
         );
     }
   }
+}
+
+EFI_STATUS
+DwEmmcExecTrb (
+  IN DW_MMC_HC_PRIVATE_DATA  *Private,
+  IN DW_MMC_HC_TRB           *Trb
+  )
+{
+  UINTN       DevBase;
+  UINT32      IntStatus;
+  UINT32      ErrMask;
+  UINT32      Timeout;
+  EFI_STATUS  Status;
+
+  DevBase = Trb->Private->DevBase;
+
+  DwEmmcSendCmd (Private, Trb);
+
+  ErrMask = DW_MMC_INT_EBE | DW_MMC_INT_HLE | DW_MMC_INT_RTO |
+            DW_MMC_INT_RCRC | DW_MMC_INT_RE;
+  ErrMask |= DW_MMC_INT_DCRC | DW_MMC_INT_DRT | DW_MMC_INT_SBE;
+  Timeout  = 10000;
+  do {
+    if (--Timeout == 0) {
+      return EFI_TIMEOUT;
+    }
+
+    IntStatus = MmioRead32 (DevBase + DW_MMC_RINTSTS);
+    if (IntStatus & ErrMask) {
+      return EFI_DEVICE_ERROR;
+    }
+
+    MicroSecondDelay (10);
+  } while (!(IntStatus & DW_MMC_INT_CMD_DONE));
+
+  //
+  // Only the tuning block is read through the FIFO here, IDMAC transfers
+  // are completed by DwMmcCheckTrbResult().
+  //
+  if (Trb->DataLen) {
+    Status = TransferFifo (Trb);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  DwEmmcGetResponse (Trb);
 
   return EFI_SUCCESS;
 }
 
-EFI_STATUS
-DwSdExecTrb (
+/**
+  Issue the command of the TRB to an SD device, without waiting for it.
+
+  @param[in] Private        A pointer to the DW_MMC_HC_PRIVATE_DATA instance.
+  @param[in] Trb            The pointer to the DW_MMC_HC_TRB instance.
+
+**/
+STATIC
+VOID
+DwSdSendCmd (
   IN DW_MMC_HC_PRIVATE_DATA  *Private,
   IN DW_MMC_HC_TRB           *Trb
   )
@@ -1351,12 +1630,6 @@ DwSdExecTrb (
   UINT32                               MmcStatus;
   UINT32                               IntStatus;
   UINT32                               Argument;
-  UINT32                               ErrMask;
-  UINT32                               Timeout;
-  UINT32                               Idsts;
-  UINT32                               BytCnt;
-  UINT32                               BlkSize;
-  EFI_STATUS                           Status;
 
   Packet  = Trb->Packet;
   DevBase = Trb->Private->DevBase;
@@ -1396,8 +1669,18 @@ DwSdExecTrb (
              BIT_CMD_WRITE;
     }
 
-    Cmd |= BIT_CMD_RESPONSE_EXPECT | BIT_CMD_CHECK_RESPONSE_CRC |
-           BIT_CMD_SEND_AUTO_STOP;
+    Cmd |= BIT_CMD_RESPONSE_EXPECT | BIT_CMD_CHECK_RESPONSE_CRC;
+
+    //
+    // Open-ended multiple block transfers are ended by a CMD12 sent by the
+    // controller. Other commands must not get one, the card rejects it.
+    //
+    if ((Packet->SdMmcCmdBlk->CommandIndex == SD_READ_MULTIPLE_BLOCK) ||
+        (Packet->SdMmcCmdBlk->CommandIndex == SD_WRITE_MULTIPLE_BLOCK))
+    {
+      Cmd          |= BIT_CMD_SEND_AUTO_STOP;
+      Trb->AutoStop = TRUE;
+    }
   } else {
     switch (Packet->SdMmcCmdBlk->CommandIndex) {
       case SD_GO_IDLE_STATE:
@@ -1425,35 +1708,7 @@ DwSdExecTrb (
   Cmd |= BIT_CMD_USE_HOLD_REG | BIT_CMD_START;
 
   if (Trb->UseFifo == TRUE) {
-    BytCnt = Trb->Read ? Packet->InTransferLength : Packet->OutTransferLength;
-    MmioWrite32 (DevBase + DW_MMC_BYTCNT, BytCnt);
-    if (Trb->Read) {
-      if (Packet->InTransferLength > DW_MMC_BLOCK_SIZE) {
-        BlkSize = DW_MMC_BLOCK_SIZE;
-      } else {
-        BlkSize = Packet->InTransferLength;
-      }
-    } else {
-      if (Packet->OutTransferLength > DW_MMC_BLOCK_SIZE) {
-        BlkSize = DW_MMC_BLOCK_SIZE;
-      } else {
-        BlkSize = Packet->OutTransferLength;
-      }
-    }
-
-    MmioWrite32 (DevBase + DW_MMC_BLKSIZ, BlkSize);
-
-    if (Trb->DataLen) {
-      Status = DwMmcHcWaitReset (DevBase, DW_MMC_CTRL_FIFO_RESET);
-      if (EFI_ERROR (Status)) {
-        DEBUG ((
-          DEBUG_ERROR,
-          "%a: FIFO reset timed out. CmdIndex=%d\n",
-          __func__,
-          Packet->SdMmcCmdBlk->CommandIndex
-          ));
-      }
-    }
+    DwMmcSetupFifo (Trb);
   }
 
   Argument = Packet->SdMmcCmdBlk->CommandArgument;
@@ -1463,63 +1718,25 @@ DwSdExecTrb (
   MmioWrite32 (DevBase + DW_MMC_CMD, Cmd);
   ArmDataSynchronizationBarrier ();
   ArmInstructionSynchronizationBarrier ();
+}
 
-  ErrMask = DW_MMC_INT_EBE | DW_MMC_INT_HLE | DW_MMC_INT_RTO |
-            DW_MMC_INT_RCRC | DW_MMC_INT_RE;
-  ErrMask |= DW_MMC_INT_DRT | DW_MMC_INT_SBE;
-  if (Packet->InTransferLength || Packet->OutTransferLength) {
-    ErrMask |= DW_MMC_INT_DCRC;
-  }
-
-  Timeout = 10000;
-  do {
-    if (--Timeout == 0) {
-      break;
-    }
+/**
+  Fetch the response of a completed SD command.
 
-    IntStatus = MmioRead32 (DevBase + DW_MMC_RINTSTS);
-    MicroSecondDelay (1);
-  } while (!(IntStatus & DW_MMC_INT_CMD_DONE));
+  @param[in] Trb            The pointer to the DW_MMC_HC_TRB instance.
 
-  if (IntStatus & ErrMask) {
-    DEBUG ((
-      DEBUG_ERROR,
-      "%a: Command error. CmdIndex=%d, IntStatus=%p\n",
-      __func__,
-      Packet->SdMmcCmdBlk->CommandIndex,
-      IntStatus
-      ));
-    return EFI_DEVICE_ERROR;
-  }
+**/
+STATIC
+VOID
+DwSdGetResponse (
+  IN DW_MMC_HC_TRB  *Trb
+  )
+{
+  EFI_SD_MMC_PASS_THRU_COMMAND_PACKET  *Packet;
+  UINTN                                DevBase;
 
-  if (Trb->DataLen) {
-    if (Trb->UseFifo == TRUE) {
-      Status = TransferFifo (Trb);
-      if (EFI_ERROR (Status)) {
-        return Status;
-      }
-    } else {
-      if (Packet->InTransferLength) {
-        do {
-          Idsts = MmioRead32 (DevBase + DW_MMC_IDSTS);
-        } while ((Idsts & DW_MMC_IDSTS_RI) == 0);
-
-        Status = DwMmcHcStopDma (Private, Trb);
-        if (EFI_ERROR (Status)) {
-          return Status;
-        }
-      } else if (Packet->OutTransferLength) {
-        do {
-          Idsts = MmioRead32 (DevBase + DW_MMC_IDSTS);
-        } while ((Idsts & DW_MMC_IDSTS_TI) == 0);
-
-        Status = DwMmcHcStopDma (Private, Trb);
-        if (EFI_ERROR (Status)) {
-          return Status;
-        }
-      } /* Packet->InTransferLength */
-    } /* UseFifo */
-  } /* Trb->DataLen */
+  Packet  = Trb->Packet;
+  DevBase = Trb->Private->DevBase;
 
   switch (Packet->SdMmcCmdBlk->ResponseType) {
     case SdMmcResponseTypeR1:
@@ -1560,6 +1777,66 @@ DwSdExecTrb (
         );
     }
   }
+}
+
+EFI_STATUS
+DwSdExecTrb (
+  IN DW_MMC_HC_PRIVATE_DATA  *Private,
+  IN DW_MMC_HC_TRB           *Trb
+  )
+{
+  EFI_SD_MMC_PASS_THRU_COMMAND_PACKET  *Packet;
+  UINTN                                DevBase;
+  UINT32                               IntStatus;
+  UINT32                               ErrMask;
+  UINT32                               Timeout;
+  EFI_STATUS                           Status;
+
+  Packet  = Trb->Packet;
+  DevBase = Trb->Private->DevBase;
+
+  DwSdSendCmd (Private, Trb);
+
+  ErrMask = DW_MMC_INT_EBE | DW_MMC_INT_HLE | DW_MMC_INT_RTO |
+            DW_MMC_INT_RCRC | DW_MMC_INT_RE;
+  ErrMask |= DW_MMC_INT_DRT | DW_MMC_INT_SBE;
+  if (Packet->InTransferLength || Packet->OutTransferLength) {
+    ErrMask |= DW_MMC_INT_DCRC;
+  }
+
+  Timeout = 10000;
+  do {
+    if (--Timeout == 0) {
+      break;
+    }
+
+    IntStatus = MmioRead32 (DevBase + DW_MMC_RINTSTS);
+    MicroSecondDelay (1);
+  } while (!(IntStatus & DW_MMC_INT_CMD_DONE));
+
+  if (IntStatus & ErrMask) {
+    DEBUG ((
+      DEBUG_ERROR,
+      "%a: Command error. CmdIndex=%d, IntStatus=%p\n",
+      __func__,
+      Packet->SdMmcCmdBlk->CommandIndex,
+      IntStatus
+      ));
+    return EFI_DEVICE_ERROR;
+  }
+
+  //
+  // IDMAC transfers never get here, DwMmcExecTrb() leaves them to
+  // DwMmcCheckTrbResult().
+  //
+  if (Trb->DataLen) {
+    Status = TransferFifo (Trb);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  DwSdGetResponse (Trb);
 
   return EFI_SUCCESS;
 }
@@ -1585,6 +1862,37 @@ DwMmcExecTrb (
   UINT32      Slot;
 
   Slot = Trb->Slot;
+
+  //
+  // Set up the IDMAC now that the controller belongs to this TRB.
+  //
+  if (Trb->DataMap != NULL) {
+    Status = BuildDmaDescTable (Trb);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    Status = DwMmcHcStartDma (Private, Trb);
+    if (EFI_ERROR (Status)) {
+      FreeDmaDescTable (Trb);
+      return Status;
+    }
+
+    //
+    // IDMAC transfers only issue the command. The completion is collected
+    // by DwMmcCheckTrbResult(), from the async timer for queued TRBs or
+    // from DwMmcWaitTrbResult() for blocking ones.
+    //
+    if (Private->Slot[Slot].CardType == EmmcCardType) {
+      DwEmmcSendCmd (Private, Trb);
+    } else {
+      DwSdSendCmd (Private, Trb);
+    }
+
+    Trb->CmdIssued = TRUE;
+    return EFI_SUCCESS;
+  }
+
   if (Private->Slot[Slot].CardType == EmmcCardType) {
     Status = DwEmmcExecTrb (Private, Trb);
   } else if (Private->Slot[Slot].CardType == SdCardType) {
@@ -1596,6 +1904,77 @@ DwMmcExecTrb (
   return Status;
 }
 
+/**
+  Check the result of a TRB whose command was issued without waiting.
+
+  @param[in] Private        A pointer to the DW_MMC_HC_PRIVATE_DATA instance.
+  @param[in] Trb            The pointer to the DW_MMC_HC_TRB instance.
+
+  @retval EFI_SUCCESS       The TRB is executed successfully.
+  @retval EFI_NOT_READY     The TRB is not completed for execution.
+  @retval Others            Some erros happen when executing this request.
+
+**/
+STATIC
+EFI_STATUS
+DwMmcCheckAsyncTrbResult (
+  IN DW_MMC_HC_PRIVATE_DATA  *Private,
+  IN DW_MMC_HC_TRB           *Trb
+  )
+{
+  UINTN       DevBase;
+  UINT32      IntStatus;
+  UINT32      ErrMask;
+  UINT32      Idsts;
+  EFI_STATUS  Status;
+
+  DevBase = Private->DevBase;
+  ErrMask = DW_MMC_INT_EBE | DW_MMC_INT_HLE | DW_MMC_INT_RTO |
+            DW_MMC_INT_RCRC | DW_MMC_INT_RE;
+  ErrMask |= DW_MMC_INT_DCRC | DW_MMC_INT_DRT | DW_MMC_INT_SBE;
+
+  IntStatus = MmioRead32 (DevBase + DW_MMC_RINTSTS);
+  if (IntStatus & ErrMask) {
+    DEBUG ((
+      DEBUG_ERROR,
+      "%a: Transfer error. CmdIndex=%d, IntStatus=%p\n",
+      __func__,
+      Trb->Packet->SdMmcCmdBlk->CommandIndex,
+      IntStatus
+      ));
+    Trb->CmdIssued = FALSE;
+    DwMmcHcStopDma (Private, Trb);
+    return EFI_DEVICE_ERROR;
+  }
+
+  if ((IntStatus & (DW_MMC_INT_CMD_DONE | DW_MMC_INT_DTO)) !=
+      (DW_MMC_INT_CMD_DONE | DW_MMC_INT_DTO))
+  {
+    return EFI_NOT_READY;
+  }
+
+  if (Trb->AutoStop && !(IntStatus & DW_MMC_INT_ACD)) {
+    return EFI_NOT_READY;
+  }
+
+  Idsts = MmioRead32 (DevBase + DW_MMC_IDSTS);
+  if ((Idsts & (Trb->Read ? DW_MMC_IDSTS_RI : DW_MMC_IDSTS_TI)) == 0) {
+    return EFI_NOT_READY;
+  }
+
+  Trb->CmdIssued = FALSE;
+  Status         = DwMmcHcStopDma (Private, Trb);
+  MmioWrite32 (DevBase + DW_MMC_IDSTS, ~0);
+
+  if (Private->Slot[Trb->Slot].CardType == EmmcCardType) {
+    DwEmmcGetResponse (Trb);
+  } else {
+    DwSdGetResponse (Trb);
+  }
+
+  return Status;
+}
+
 /**
   Check the TRB execution result.
 
@@ -1620,16 +1999,23 @@ DwMmcCheckTrbResult (
 
   DevBase = Private->DevBase;
   Packet  = Trb->Packet;
+  if (Trb->CmdIssued) {
+    return DwMmcCheckAsyncTrbResult (Private, Trb);
+  }
+
+  //
+  // Check Auto CMD12 completion
+  //
+  if (Trb->DataLen && Trb->AutoStop) {
+    IntStatus = MmioRead32 (DevBase + DW_MMC_RINTSTS);
+    if (!(IntStatus & DW_MMC_INT_ACD)) {
+      return EFI_NOT_READY;
+    }
+  }
+
   if (Trb->UseFifo == TRUE) {
     if (Trb->DataLen) {
       IntStatus = MmioRead32 (DevBase + DW_MMC_RINTSTS);
-      //
-      // Check Auto CMD12 completion
-      //
-      if (!(IntStatus & DW_MMC_INT_ACD)) {
-        return EFI_NOT_READY;
-      }
-
       //
       // Check data trans over
       //
@@ -1657,13 +2043,15 @@ DwMmcCheckTrbResult (
   }
 
   if (Packet->InTransferLength) {
-    do {
-      Idsts = MmioRead32 (DevBase + DW_MMC_IDSTS);
-    } while ((Idsts & BIT1) == 0);
+    Idsts = MmioRead32 (DevBase + DW_MMC_IDSTS);
+    if ((Idsts & BIT1) == 0) {
+      return EFI_NOT_READY;
+    }
   } else if (Packet->OutTransferLength) {
-    do {
-      Idsts = MmioRead32 (DevBase + DW_MMC_IDSTS);
-    } while ((Idsts & BIT0) == 0);
+    Idsts = MmioRead32 (DevBase + DW_MMC_IDSTS);
+    if ((Idsts & BIT0) == 0) {
+      return EFI_NOT_READY;
+    }
   } else {
     return EFI_SUCCESS;
   }
@@ -187,7 +187,11 @@
 #define UHSEXT_SAMPLE_DRVPHASE(x)  (((x) & 0x1f) << 21)
 #define UHSEXT_SAMPLE_DLY(x)       (((x) & 0x1f) << 26)
 
-#define DWMMC_DMA_BUF_SIZE    (512 * 8)
+//
+// Data carried by one IDMAC descriptor. The buffer size field is 13 bits
+// wide, keep each chunk a whole number of blocks below that limit.
+//
+#define DWMMC_DMA_BUF_SIZE    (SIZE_8KB - DW_MMC_BLOCK_SIZE)
 #define DWMMC_FIFO_THRESHOLD  16
 
 #define DWMMC_INIT_CLOCK_FREQ  400                               /* KHz */
@@ -215,6 +219,16 @@ typedef struct {
   UINT32    Des3;
 } DW_MMC_HC_DMA_DESC_LINE;
 
+//
+// Largest transfer served from the per-controller descriptor pool, this
+// covers the 0xFFFF block requests issued by SdDxe and EmmcDxe.
+//
+#define DWMMC_DMA_POOL_MAX_TRANSFER  SIZE_32MB
+#define DWMMC_DMA_POOL_ENTRIES       \
+  ((DWMMC_DMA_POOL_MAX_TRANSFER + DWMMC_DMA_BUF_SIZE - 1) / DWMMC_DMA_BUF_SIZE)
+#define DWMMC_DMA_POOL_PAGES         \
+  EFI_SIZE_TO_PAGES (DWMMC_DMA_POOL_ENTRIES * sizeof (DW_MMC_HC_DMA_DESC_LINE))
+
 #define SD_MMC_SDMA_BOUNDARY  512 * 1024
 #define SD_MMC_SDMA_ROUND_UP(x, n)  (((x) + n) & ~(n - 1))
 
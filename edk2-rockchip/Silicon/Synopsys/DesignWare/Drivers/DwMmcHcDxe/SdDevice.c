@@ -12,9 +12,46 @@
 
 #include <Library/BaseMemoryLib.h>
 #include <Library/DebugLib.h>
+#include <Library/PrintLib.h>
+#include <Library/UefiRuntimeServicesTableLib.h>
 
 #include "DwMmcHcDxe.h"
 
+//
+// Number of sample phases tried by the SDR50/SDR104 tuning sweep, evenly
+// spread over 360 degrees. Must not exceed 32 (one bit per phase).
+//
+#define SD_TUNING_PHASE_STEPS  32
+
+//
+// Tuning block pattern for a 4-bit bus, refer to SD Physical Layer
+// Simplified Spec 4.1 Section 4.3.13.
+//
+STATIC CONST UINT8  mSdTuningBlockPattern4Bit[64] = {
+  0xff, 0x0f, 0xff, 0x00, 0xff, 0xcc, 0xc3, 0xcc,
+  0xc3, 0x3c, 0xcc, 0xff, 0xfe, 0xff, 0xfe, 0xef,
+  0xff, 0xdf, 0xff, 0xdd, 0xff, 0xfb, 0xff, 0xfb,
+  0xbf, 0xff, 0x7f, 0xff, 0x77, 0xf7, 0xbd, 0xef,
+  0xff, 0xf0, 0xff, 0xf0, 0x0f, 0xfc, 0xcc, 0x3c,
+  0xcc, 0x33, 0xcc, 0xcf, 0xff, 0xef, 0xff, 0xee,
+  0xff, 0xfd, 0xff, 0xfd, 0xdf, 0xff, 0xbf, 0xff,
+  0xbb, 0xff, 0xf7, 0xff, 0xf7, 0x7f, 0x7b, 0xde,
+};
+
+//
+// Tuning result cached in a volatile variable named after the card CID, so
+// that re-identifying the same card skips the phase sweep.
+//
+typedef struct {
+  UINT64    DevBase;
+  UINT32    AccessMode;
+  UINT32    SamplePhase;
+} SD_TUNING_CACHE;
+
+STATIC EFI_GUID  mSdTuningCacheGuid = {
+  0x4d2a6c8e, 0x1f3b, 0x4e57, { 0x9a, 0x0c, 0x63, 0xb8, 0x51, 0xd7, 0x2e, 0x94 }
+};
+
 /**
   Send command GO_IDLE_STATE to the device to make it go to Idle State.
 
@@ -235,8 +272,9 @@ SdCardSendOpCond (
 
   Refer to SD Physical Layer Simplified Spec 4.1 Section 4.7 for details.
 
-  @param[in] PassThru       A pointer to the EFI_SD_MMC_PASS_THRU_PROTOCOL
+  @param[in]  PassThru      A pointer to the EFI_SD_MMC_PASS_THRU_PROTOCOL
                             instance.
+  @param[out] Cid           The raw R2 response holding the CID register.
 
   @retval EFI_SUCCESS       The operation is done correctly.
   @retval Others            The operation fails.
@@ -244,7 +282,8 @@ SdCardSendOpCond (
 **/
 EFI_STATUS
 SdCardAllSendCid (
-  IN EFI_SD_MMC_PASS_THRU_PROTOCOL  *PassThru
+  IN     EFI_SD_MMC_PASS_THRU_PROTOCOL  *PassThru,
+  OUT UINT32                            *Cid
   )
 {
   EFI_SD_MMC_COMMAND_BLOCK             SdMmcCmdBlk;
@@ -265,6 +304,12 @@ SdCardAllSendCid (
   SdMmcCmdBlk.ResponseType = SdMmcResponseTypeR2;
 
   Status = PassThru->PassThru (PassThru, 0, &Packet, NULL);
+  if (!EFI_ERROR (Status)) {
+    Cid[0] = SdMmcStatusBlk.Resp0;
+    Cid[1] = SdMmcStatusBlk.Resp1;
+    Cid[2] = SdMmcStatusBlk.Resp2;
+    Cid[3] = SdMmcStatusBlk.Resp3;
+  }
 
   return Status;
 }
@@ -723,8 +768,198 @@ SdCardSendTuningBlk (
   Packet.InTransferLength = sizeof (TuningBlock);
 
   Status = PassThru->PassThru (PassThru, 0, &Packet, NULL);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
 
-  return Status;
+  if (CompareMem (TuningBlock, mSdTuningBlockPattern4Bit, sizeof (TuningBlock)) != 0) {
+    return EFI_CRC_ERROR;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Build the name of the volatile variable caching the tuning result of
+  the card with the given CID.
+
+  @param[in]  Cid           The raw CID register of the card.
+  @param[out] Name          The variable name buffer.
+  @param[in]  NameSize      The size in bytes of the name buffer.
+
+**/
+STATIC
+VOID
+SdCardGetTuningCacheName (
+  IN  CONST UINT32  *Cid,
+  OUT CHAR16        *Name,
+  IN  UINTN         NameSize
+  )
+{
+  UnicodeSPrint (
+    Name,
+    NameSize,
+    L"SdTuning%08x%08x%08x%08x",
+    Cid[3],
+    Cid[2],
+    Cid[1],
+    Cid[0]
+    );
+}
+
+/**
+  Sweep the sample clock phase of the card clock for SDR50/SDR104 and
+  select the centre of the largest window where the tuning block is
+  received correctly.
+
+  The selected phase is cached per card CID in a volatile variable, so a
+  later identification of the same card only needs to verify it.
+
+  @param[in] Private        A pointer to the DW_MMC_HC_PRIVATE_DATA instance.
+  @param[in] Cid            The raw CID register of the card.
+  @param[in] AccessMode     The access mode the card was switched to.
+
+  @retval EFI_SUCCESS       The tuning is done correctly.
+  @retval EFI_UNSUPPORTED   The platform cannot change the clock phases.
+  @retval Others            No working sample phase was found.
+
+**/
+STATIC
+EFI_STATUS
+SdCardTuningClock (
+  IN DW_MMC_HC_PRIVATE_DATA  *Private,
+  IN CONST UINT32            *Cid,
+  IN UINT8                   AccessMode
+  )
+{
+  EFI_STATUS                     Status;
+  EFI_SD_MMC_PASS_THRU_PROTOCOL  *PassThru;
+  PLATFORM_DW_MMC_PROTOCOL       *PlatformDwMmc;
+  EFI_HANDLE                     Controller;
+  CHAR16                         VariableName[48];
+  SD_TUNING_CACHE                Cache;
+  UINTN                          Size;
+  UINT32                         PassMask;
+  UINT32                         Index;
+  UINT32                         Length;
+  UINT32                         BestStart;
+  UINT32                         BestLength;
+  UINT32                         Phase;
+
+  PassThru      = &Private->PassThru;
+  PlatformDwMmc = Private->PlatformDwMmc;
+  Controller    = Private->Capability[0].Controller;
+
+  if (PlatformDwMmc->SetClockPhase == NULL) {
+    return EFI_UNSUPPORTED;
+  }
+
+  Status = PlatformDwMmc->SetClockPhase (Controller, 0, DwMmcDrivePhase, 180);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  SdCardGetTuningCacheName (Cid, VariableName, sizeof (VariableName));
+
+  Size   = sizeof (Cache);
+  Status = gRT->GetVariable (VariableName, &mSdTuningCacheGuid, NULL, &Size, &Cache);
+  if (!EFI_ERROR (Status) && (Size == sizeof (Cache)) &&
+      (Cache.DevBase == Private->DevBase) && (Cache.AccessMode == AccessMode))
+  {
+    Status = PlatformDwMmc->SetClockPhase (Controller, 0, DwMmcSamplePhase, Cache.SamplePhase);
+    if (!EFI_ERROR (Status)) {
+      Status = SdCardSendTuningBlk (PassThru);
+    }
+
+    if (!EFI_ERROR (Status)) {
+      DEBUG ((
+        DEBUG_INFO,
+        "SdCardTuningClock: Reusing cached sample phase %d degrees\n",
+        Cache.SamplePhase
+        ));
+      return EFI_SUCCESS;
+    }
+  }
+
+  //
+  // Try every sample phase and record which ones pass.
+  //
+  PassMask = 0;
+  for (Index = 0; Index < SD_TUNING_PHASE_STEPS; Index++) {
+    Phase  = Index * 360 / SD_TUNING_PHASE_STEPS;
+    Status = PlatformDwMmc->SetClockPhase (Controller, 0, DwMmcSamplePhase, Phase);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    if (!EFI_ERROR (SdCardSendTuningBlk (PassThru))) {
+      PassMask |= 1U << Index;
+    }
+  }
+
+  if (PassMask == 0) {
+    DEBUG ((DEBUG_ERROR, "SdCardTuningClock: No working sample phase found\n"));
+    return EFI_DEVICE_ERROR;
+  }
+
+  //
+  // Find the largest window of passing phases, which may wrap around
+  // 360 degrees, and select its centre.
+  //
+  BestStart  = 0;
+  BestLength = SD_TUNING_PHASE_STEPS;
+  if (PassMask != (UINT32)((1ULL << SD_TUNING_PHASE_STEPS) - 1)) {
+    BestLength = 0;
+    for (Index = 0; Index < SD_TUNING_PHASE_STEPS; Index++) {
+      if (((PassMask & (1U << Index)) == 0) ||
+          ((PassMask & (1U << ((Index + SD_TUNING_PHASE_STEPS - 1) % SD_TUNING_PHASE_STEPS))) != 0))
+      {
+        continue;
+      }
+
+      Length = 0;
+      while ((PassMask & (1U << ((Index + Length) % SD_TUNING_PHASE_STEPS))) != 0) {
+        Length++;
+      }
+
+      if (Length > BestLength) {
+        BestStart  = Index;
+        BestLength = Length;
+      }
+    }
+  }
+
+  Phase = ((BestStart + BestLength / 2) % SD_TUNING_PHASE_STEPS) * 360 / SD_TUNING_PHASE_STEPS;
+
+  DEBUG ((
+    DEBUG_INFO,
+    "SdCardTuningClock: Pass mask 0x%08x, window %d-%d, sample phase %d degrees\n",
+    PassMask,
+    BestStart * 360 / SD_TUNING_PHASE_STEPS,
+    ((BestStart + BestLength - 1) % SD_TUNING_PHASE_STEPS) * 360 / SD_TUNING_PHASE_STEPS,
+    Phase
+    ));
+
+  Status = PlatformDwMmc->SetClockPhase (Controller, 0, DwMmcSamplePhase, Phase);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Cache.DevBase     = Private->DevBase;
+  Cache.AccessMode  = AccessMode;
+  Cache.SamplePhase = Phase;
+  Status            = gRT->SetVariable (
+                             VariableName,
+                             &mSdTuningCacheGuid,
+                             EFI_VARIABLE_BOOTSERVICE_ACCESS,
+                             sizeof (Cache),
+                             &Cache
+                             );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_WARN, "SdCardTuningClock: Failed to cache sample phase. Status=%r\n", Status));
+  }
+
+  return EFI_SUCCESS;
 }
 
 /**
@@ -805,6 +1040,7 @@ SdCardSwitchBusWidth (
   @param[in] S18A           The boolean to show if it's a UHS-I SD card.
   @param[in] BusWidths      The bus width of the SD card.
   @param[in] SdVersion1     The boolean to show if it's a Version 1 SD card.
+  @param[in] Cid            The raw CID register of the SD card.
 
   @retval EFI_SUCCESS       The operation is done correctly.
   @retval Others            The operation fails.
@@ -817,7 +1053,8 @@ SdCardSetBusMode (
   IN UINT16                         Rca,
   IN BOOLEAN                        S18A,
   IN UINT32                         BusWidths,
-  IN BOOLEAN                        SdVersion1
+  IN BOOLEAN                        SdVersion1,
+  IN CONST UINT32                   *Cid
   )
 {
   EFI_STATUS              Status;
@@ -938,6 +1175,16 @@ SdCardSetBusMode (
     return Status;
   }
 
+  //
+  // SDR50 and SDR104 need the sample point of the card clock tuned.
+  //
+  if ((AccessMode == 2) || (AccessMode == 3)) {
+    Status = SdCardTuningClock (Private, Cid, AccessMode);
+    if (Status == EFI_UNSUPPORTED) {
+      Status = EFI_SUCCESS;
+    }
+  }
+
   return Status;
 }
 
@@ -957,6 +1204,7 @@ SdCardIdentification (
   SD_SCR                         Scr;
   SD_CSD                         Csd;
   BOOLEAN                        SdVersion1;
+  UINT32                         Cid[4];
 
   DevBase    = Private->DevBase;
   PassThru   = &Private->PassThru;
@@ -1050,7 +1298,7 @@ SdCardIdentification (
     }
   } while ((Ocr & BIT31) == 0);
 
-  Status = SdCardAllSendCid (PassThru);
+  Status = SdCardAllSendCid (PassThru, Cid);
   if (EFI_ERROR (Status)) {
     DEBUG ((
       DEBUG_ERROR,
@@ -1106,7 +1354,7 @@ SdCardIdentification (
   DEBUG ((DEBUG_INFO, "SdCardIdentification: Found a SD device\n"));
   Private->Slot[0].CardType = SdCardType;
 
-  Status = SdCardSetBusMode (DevBase, PassThru, Rca, S18r, Scr.SdBusWidths, SdVersion1);
+  Status = SdCardSetBusMode (DevBase, PassThru, Rca, S18r, Scr.SdBusWidths, SdVersion1, Cid);
   if (EFI_ERROR (Status)) {
     return Status;
   }
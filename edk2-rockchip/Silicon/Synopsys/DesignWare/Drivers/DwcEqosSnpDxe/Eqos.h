@@ -28,12 +28,13 @@
 
 #include "EqosHw.h"
 
+#define EQOS_TX_DESC_COUNT  FixedPcdGet32 (PcdDwcEqosTxDescCount)
+
 //
 // XXX: Having more RX descriptors (e.g. 256) affects performance
 // and seems to lead to more TCP segments getting dropped.
 //
-#define EQOS_TX_DESC_COUNT  32
-#define EQOS_RX_DESC_COUNT  2
+#define EQOS_RX_DESC_COUNT  FixedPcdGet32 (PcdDwcEqosRxDescCount)
 
 #define EQOS_DESC_ALIGN  sizeof (struct EQOS_DMA_DESCRIPTOR)
 
@@ -57,6 +58,26 @@
 //
 #define EQOS_RX_BUFFER_SIZE  ALIGN_VALUE (MAX_ETHERNET_FRAME_SIZE, EqosAxiBusWidth128)
 
+//
+// The RX buffers stay mapped for the lifetime of the ring and are only
+// invalidated from the CPU caches per frame, so each one must cover
+// whole cache lines.
+//
+STATIC_ASSERT (
+  (EQOS_RX_BUFFER_SIZE % 64) == 0,
+  "RX buffer size must be a multiple of the cache line size"
+  );
+
+STATIC_ASSERT (
+  (EQOS_RX_DESC_COUNT >= 2) && (EQOS_RX_DESC_COUNT <= 1024),
+  "PcdDwcEqosRxDescCount must be between 2 and 1024"
+  );
+
+STATIC_ASSERT (
+  (EQOS_TX_DESC_COUNT >= 2) && (EQOS_TX_DESC_COUNT <= 1024),
+  "PcdDwcEqosTxDescCount must be between 2 and 1024"
+  );
+
 typedef struct {
   UINT32                               Signature;
   EFI_HANDLE                           ControllerHandle;
@@ -79,14 +100,22 @@ typedef struct {
   UINT32                               TxQueued;
   UINT32                               TxNext;
   UINT32                               TxCurrent;
+  //
+  // Completed TX buffers not yet handed back to the caller by GetStatus().
+  //
+  VOID                                 *TxRecycled[EQOS_TX_DESC_COUNT];
+  UINT32                               TxRecycledCount;
 
   VOID                                 *RxDescs;
   VOID                                 *RxDescsMap;
   EFI_PHYSICAL_ADDRESS                 RxDescsPhysAddr;
   EFI_PHYSICAL_ADDRESS                 RxBuffersAddr;
-  VOID                                 *RxBuffersMap[EQOS_RX_DESC_COUNT];
+  EFI_PHYSICAL_ADDRESS                 RxBuffersPhysAddr;
+  VOID                                 *RxBuffersMap;
   UINT32                               RxCurrent;
 
+  EFI_NETWORK_STATISTICS               Stats;
+
   UINT32                               HwFeatures[4];
 
   EFI_PHYSICAL_ADDRESS                 Base;
@@ -168,7 +197,7 @@ EqosDmaMapTxDescriptor (
   IN UINTN              NumberOfBytes
   );
 
-EFI_STATUS
+VOID
 EqosDmaMapRxDescriptor (
   IN EQOS_PRIVATE_DATA  *Eqos,
   IN UINT32             DescIndex
@@ -181,9 +210,10 @@ EqosDmaUnmapTxDescriptor (
   );
 
 VOID
-EqosDmaUnmapRxDescriptor (
+EqosDmaSyncRxDescriptor (
   IN EQOS_PRIVATE_DATA  *Eqos,
-  IN UINT32             DescIndex
+  IN UINT32             DescIndex,
+  IN UINTN              FrameLength
   );
 
 EFI_STATUS
@@ -207,6 +237,11 @@ EqosCheckTxDescriptor (
   IN UINT32             DescIndex
   );
 
+UINT32
+EqosReclaimTxDescriptors (
+  IN EQOS_PRIVATE_DATA  *Eqos
+  );
+
 EFI_STATUS
 EqosCheckRxDescriptor (
   IN  EQOS_PRIVATE_DATA  *Eqos,
@@ -214,6 +249,22 @@ EqosCheckRxDescriptor (
   OUT UINTN              *FrameLength
   );
 
+VOID
+EqosResetStatistics (
+  IN EQOS_PRIVATE_DATA  *Eqos
+  );
+
+VOID
+EqosUpdateRxDropStatistics (
+  IN EQOS_PRIVATE_DATA  *Eqos
+  );
+
+VOID
+EqosSetLoopback (
+  IN EQOS_PRIVATE_DATA  *Eqos,
+  IN BOOLEAN            Enable
+  );
+
 VOID
 EqosGetDmaInterruptStatus (
   IN  EQOS_PRIVATE_DATA  *Eqos,
@@ -24,6 +24,7 @@
 #define GMAC_MAC_CONFIGURATION_PS                   (1U << 15)
 #define GMAC_MAC_CONFIGURATION_FES                  (1U << 14)
 #define GMAC_MAC_CONFIGURATION_DM                   (1U << 13)
+#define GMAC_MAC_CONFIGURATION_LM                   (1U << 12)
 #define GMAC_MAC_CONFIGURATION_DCRS                 (1U << 9)
 #define GMAC_MAC_CONFIGURATION_TE                   (1U << 1)
 #define GMAC_MAC_CONFIGURATION_RE                   (1U << 0)
@@ -210,6 +211,10 @@
 #define GMAC_MTL_RXQ0_OPERATION_MODE_FEP            (1U << 4)
 #define GMAC_MTL_RXQ0_OPERATION_MODE_FUP            (1U << 3)
 #define GMAC_MTL_RXQ0_MISS_PKT_OVF_CNT              0x0D34
+#define GMAC_MTL_RXQ0_MISS_PKT_OVF_CNT_MISCNTOVF    (1U << 27)
+#define GMAC_MTL_RXQ0_MISS_PKT_OVF_CNT_MISPKTCNT    BITS(26,16)
+#define GMAC_MTL_RXQ0_MISS_PKT_OVF_CNT_OVFCNTOVF    (1U << 11)
+#define GMAC_MTL_RXQ0_MISS_PKT_OVF_CNT_OVFPKTCNT    BITS(10,0)
 #define GMAC_MTL_RXQ0_DEBUG                         0x0D38
 #define GMAC_DMA_MODE                               0x1000
 #define GMAC_DMA_MODE_SWR                           (1U << 0)
@@ -7,6 +7,7 @@
 
 **/
 
+#include <Library/CacheMaintenanceLib.h>
 #include <Library/IoLib.h>
 
 #include "Eqos.h"
@@ -14,6 +15,8 @@
 #define DMA_DEVICE_ADDRESS_LIMIT \
   (FixedPcdGet64 (PcdDmaDeviceLimit) - FixedPcdGet64 (PcdDmaDeviceOffset))
 
+#define EQOS_TX_DRAIN_TIMEOUT  10000   // us
+
 EFI_STATUS
 EqosIdentify (
   IN EQOS_PRIVATE_DATA  *Eqos
@@ -364,9 +367,9 @@ EqosDmaInitDescriptorRings (
   IN EQOS_PRIVATE_DATA  *Eqos
   )
 {
-  Eqos->TxQueued  = 0;
-  Eqos->TxNext    = 0;
-  Eqos->TxCurrent = 0;
+  Eqos->TxQueued        = 0;
+  Eqos->TxNext          = 0;
+  Eqos->TxCurrent       = 0;
   MmioWrite32 (Eqos->Base + GMAC_DMA_CHAN0_TX_BASE_ADDR_HI, (UINT32)(Eqos->TxDescsPhysAddr >> 32));
   MmioWrite32 (Eqos->Base + GMAC_DMA_CHAN0_TX_BASE_ADDR, (UINT32)(Eqos->TxDescsPhysAddr));
   MmioWrite32 (Eqos->Base + GMAC_DMA_CHAN0_TX_RING_LEN, EQOS_TX_DESC_COUNT - 1);
@@ -396,6 +399,8 @@ EqosStart (
 
   EqosDmaInitDescriptorRings (Eqos);
 
+  EqosResetStatistics (Eqos);
+
   EqosEnableTxRx (Eqos);
 
   return EFI_SUCCESS;
@@ -406,8 +411,38 @@ EqosStop (
   IN EQOS_PRIVATE_DATA  *Eqos
   )
 {
+  UINT32  Retry;
+  UINT32  DescIndex;
+
+  //
+  // Let the DMA finish the frames still queued, so that they go out
+  // on the wire instead of being flushed.
+  //
+  for (Retry = EQOS_TX_DRAIN_TIMEOUT / 10; (Retry > 0) && (Eqos->TxQueued > 0); Retry--) {
+    if (EqosReclaimTxDescriptors (Eqos) == 0) {
+      gBS->Stall (10);
+    }
+  }
+
   EqosDisableTxRx (Eqos);
 
+  //
+  // Anything left was flushed from the TX queue. The buffers still belong
+  // to the caller and must be handed back through GetStatus().
+  //
+  while (Eqos->TxQueued > 0) {
+    DescIndex = Eqos->TxCurrent;
+
+    EqosDmaUnmapTxDescriptor (Eqos, DescIndex);
+
+    ASSERT (Eqos->TxRecycledCount < EQOS_TX_DESC_COUNT);
+    Eqos->TxRecycled[Eqos->TxRecycledCount++] = Eqos->TxBuffers[DescIndex];
+    Eqos->Stats.TxDroppedFrames++;
+
+    Eqos->TxCurrent = EQOS_TX_NEXT (DescIndex);
+    Eqos->TxQueued--;
+  }
+
   EqosDmaUnmapAllTxDescriptors (Eqos);
   EqosDmaUnmapAllRxDescriptors (Eqos);
 
@@ -585,33 +620,22 @@ EqosDmaMapTxDescriptor (
   return EFI_SUCCESS;
 }
 
-EFI_STATUS
+VOID
 EqosDmaMapRxDescriptor (
   IN EQOS_PRIVATE_DATA  *Eqos,
   IN UINT32             DescIndex
   )
 {
-  EFI_STATUS            Status;
-  UINTN                 NumberOfBytes;
   EFI_PHYSICAL_ADDRESS  BufferPhysAddr;
   EQOS_DMA_DESCRIPTOR   *Descriptor;
 
-  ASSERT (Eqos->RxBuffersMap[DescIndex] == NULL);
-  ASSERT (Eqos->RxBuffersAddr != 0);
-
-  NumberOfBytes = EQOS_RX_BUFFER_SIZE;
+  ASSERT (Eqos->RxBuffersMap != NULL);
 
-  Status = DmaMap (
-             MapOperationBusMasterWrite,
-             EQOS_RX_BUFFER (Eqos, DescIndex),
-             &NumberOfBytes,
-             &BufferPhysAddr,
-             &Eqos->RxBuffersMap[DescIndex]
-             );
-  if (EFI_ERROR (Status)) {
-    DEBUG ((DEBUG_ERROR, "%a: Failed to map RX buffer. Status=%r\n", __func__, Status));
-    return Status;
-  }
+  //
+  // The RX buffers are mapped once for the whole ring, so handing a
+  // buffer back to the DMA only requires re-arming its descriptor.
+  //
+  BufferPhysAddr = Eqos->RxBuffersPhysAddr + EQOS_RX_BUFFER_SIZE * DescIndex;
 
   Descriptor = EQOS_DESC (Eqos->RxDescs, DescIndex);
 
@@ -622,8 +646,6 @@ EqosDmaMapRxDescriptor (
   Descriptor->Tdes3 = EQOS_TDES3_RX_OWN | EQOS_TDES3_RX_IOC | EQOS_TDES3_RX_BUF1V;
 
   MmioWrite32 (Eqos->Base + GMAC_DMA_CHAN0_RX_END_ADDR, (UINT32)(UINTN)Descriptor);
-
-  return EFI_SUCCESS;
 }
 
 VOID
@@ -639,15 +661,19 @@ EqosDmaUnmapTxDescriptor (
 }
 
 VOID
-EqosDmaUnmapRxDescriptor (
+EqosDmaSyncRxDescriptor (
   IN EQOS_PRIVATE_DATA  *Eqos,
-  IN UINT32             DescIndex
+  IN UINT32             DescIndex,
+  IN UINTN              FrameLength
   )
 {
-  if (Eqos->RxBuffersMap[DescIndex] != NULL) {
-    DmaUnmap (Eqos->RxBuffersMap[DescIndex]);
-    Eqos->RxBuffersMap[DescIndex] = NULL;
-  }
+  ASSERT (Eqos->RxBuffersMap != NULL);
+  ASSERT (FrameLength <= EQOS_RX_BUFFER_SIZE);
+
+  //
+  // Drop any lines speculatively fetched while the DMA owned the buffer.
+  //
+  InvalidateDataCacheRange (EQOS_RX_BUFFER (Eqos, DescIndex), FrameLength);
 }
 
 EFI_STATUS
@@ -656,14 +682,28 @@ EqosDmaMapAllRxDescriptors (
   )
 {
   EFI_STATUS  Status;
+  UINTN       NumberOfBytes;
   UINT32      Index;
 
+  ASSERT (Eqos->RxBuffersMap == NULL);
+  ASSERT (Eqos->RxBuffersAddr != 0);
+
+  NumberOfBytes = EQOS_RX_BUFFER_SIZE * EQOS_RX_DESC_COUNT;
+
+  Status = DmaMap (
+             MapOperationBusMasterWrite,
+             (VOID *)(UINTN)Eqos->RxBuffersAddr,
+             &NumberOfBytes,
+             &Eqos->RxBuffersPhysAddr,
+             &Eqos->RxBuffersMap
+             );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a: Failed to map RX buffers. Status=%r\n", __func__, Status));
+    return Status;
+  }
+
   for (Index = 0; Index < EQOS_RX_DESC_COUNT; Index++) {
-    Status = EqosDmaMapRxDescriptor (Eqos, Index);
-    if (EFI_ERROR (Status)) {
-      EqosDmaUnmapAllRxDescriptors (Eqos);
-      return Status;
-    }
+    EqosDmaMapRxDescriptor (Eqos, Index);
   }
 
   return EFI_SUCCESS;
@@ -686,10 +726,9 @@ EqosDmaUnmapAllRxDescriptors (
   IN EQOS_PRIVATE_DATA  *Eqos
   )
 {
-  UINT32  Index;
-
-  for (Index = 0; Index < EQOS_RX_DESC_COUNT; Index++) {
-    EqosDmaUnmapRxDescriptor (Eqos, Index);
+  if (Eqos->RxBuffersMap != NULL) {
+    DmaUnmap (Eqos->RxBuffersMap);
+    Eqos->RxBuffersMap = NULL;
   }
 }
 
@@ -765,6 +804,48 @@ EqosCheckTxDescriptor (
   return EFI_SUCCESS;
 }
 
+UINT32
+EqosReclaimTxDescriptors (
+  IN EQOS_PRIVATE_DATA  *Eqos
+  )
+{
+  EFI_STATUS  Status;
+  UINT32      DescIndex;
+  UINT32      Reclaimed;
+
+  //
+  // Reap every descriptor the DMA has finished with, in ring order, and
+  // queue its buffer for recycling through GetStatus().
+  //
+  Reclaimed = 0;
+  while (Eqos->TxQueued > 0) {
+    DescIndex = Eqos->TxCurrent;
+
+    Status = EqosCheckTxDescriptor (Eqos, DescIndex);
+    if (Status == EFI_NOT_READY) {
+      break;
+    }
+
+    if (EFI_ERROR (Status)) {
+      Eqos->Stats.TxErrorFrames++;
+    } else {
+      Eqos->Stats.TxGoodFrames++;
+    }
+
+    ASSERT (Eqos->TxBuffersMap[DescIndex] != NULL);
+    EqosDmaUnmapTxDescriptor (Eqos, DescIndex);
+
+    ASSERT (Eqos->TxRecycledCount < EQOS_TX_DESC_COUNT);
+    Eqos->TxRecycled[Eqos->TxRecycledCount++] = Eqos->TxBuffers[DescIndex];
+
+    Eqos->TxCurrent = EQOS_TX_NEXT (DescIndex);
+    Eqos->TxQueued--;
+    Reclaimed++;
+  }
+
+  return Reclaimed;
+}
+
 EFI_STATUS
 EqosCheckRxDescriptor (
   IN  EQOS_PRIVATE_DATA  *Eqos,
@@ -785,12 +866,17 @@ EqosCheckRxDescriptor (
   }
 
   if (Tdes3 & EQOS_TDES3_RX_ES) {
+    Eqos->Stats.RxTotalFrames++;
+    Eqos->Stats.RxDroppedFrames++;
+
     if (Tdes3 & EQOS_TDES3_RX_CE) {
       DEBUG ((DEBUG_ERROR, "%a: CRC Error\n", __func__));
+      Eqos->Stats.RxCrcErrorFrames++;
     }
 
     if (Tdes3 & EQOS_TDES3_RX_GP) {
       DEBUG ((DEBUG_ERROR, "%a: Giant Packet\n", __func__));
+      Eqos->Stats.RxOversizeFrames++;
     }
 
     if (Tdes3 & EQOS_TDES3_RX_RWT) {
@@ -833,6 +919,82 @@ EqosCheckRxDescriptor (
   return EFI_SUCCESS;
 }
 
+VOID
+EqosResetStatistics (
+  IN EQOS_PRIVATE_DATA  *Eqos
+  )
+{
+  EFI_NETWORK_STATISTICS  *Stats;
+
+  Stats = &Eqos->Stats;
+
+  //
+  // Counters the driver does not track are reported as unavailable (-1).
+  //
+  SetMem (Stats, sizeof (*Stats), 0xFF);
+
+  Stats->RxTotalFrames     = 0;
+  Stats->RxGoodFrames      = 0;
+  Stats->RxDroppedFrames   = 0;
+  Stats->RxUnicastFrames   = 0;
+  Stats->RxBroadcastFrames = 0;
+  Stats->RxMulticastFrames = 0;
+  Stats->RxCrcErrorFrames  = 0;
+  Stats->RxOversizeFrames  = 0;
+  Stats->RxTotalBytes      = 0;
+  Stats->TxTotalFrames     = 0;
+  Stats->TxGoodFrames      = 0;
+  Stats->TxDroppedFrames   = 0;
+  Stats->TxTotalBytes      = 0;
+  Stats->TxErrorFrames     = 0;
+
+  //
+  // Clear the hardware counters, they are reset on read.
+  //
+  MmioRead32 (Eqos->Base + GMAC_MTL_RXQ0_MISS_PKT_OVF_CNT);
+}
+
+VOID
+EqosUpdateRxDropStatistics (
+  IN EQOS_PRIVATE_DATA  *Eqos
+  )
+{
+  UINT32  Value;
+  UINT32  Missed;
+  UINT32  Overflow;
+
+  //
+  // Packets missed because no RX descriptor was available and packets
+  // dropped because the RX FIFO overflowed. The counters saturate, so
+  // they must be sampled before they reach 2047.
+  //
+  Value    = MmioRead32 (Eqos->Base + GMAC_MTL_RXQ0_MISS_PKT_OVF_CNT);
+  Missed   = SHIFTOUT (Value, GMAC_MTL_RXQ0_MISS_PKT_OVF_CNT_MISPKTCNT);
+  Overflow = SHIFTOUT (Value, GMAC_MTL_RXQ0_MISS_PKT_OVF_CNT_OVFPKTCNT);
+
+  if (Value & (GMAC_MTL_RXQ0_MISS_PKT_OVF_CNT_MISCNTOVF |
+               GMAC_MTL_RXQ0_MISS_PKT_OVF_CNT_OVFCNTOVF))
+  {
+    DEBUG ((DEBUG_WARN, "%a: RX drop counters saturated\n", __func__));
+  }
+
+  Eqos->Stats.RxDroppedFrames += Missed + Overflow;
+  Eqos->Stats.RxTotalFrames   += Missed + Overflow;
+}
+
+VOID
+EqosSetLoopback (
+  IN EQOS_PRIVATE_DATA  *Eqos,
+  IN BOOLEAN            Enable
+  )
+{
+  if (Enable) {
+    MmioOr32 (Eqos->Base + GMAC_MAC_CONFIGURATION, GMAC_MAC_CONFIGURATION_LM);
+  } else {
+    MmioAnd32 (Eqos->Base + GMAC_MAC_CONFIGURATION, ~GMAC_MAC_CONFIGURATION_LM);
+  }
+}
+
 VOID
 EqosGetDmaInterruptStatus (
   IN  EQOS_PRIVATE_DATA  *Eqos,
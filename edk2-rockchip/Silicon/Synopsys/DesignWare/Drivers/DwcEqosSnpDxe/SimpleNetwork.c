@@ -8,6 +8,11 @@
 
 #include "Eqos.h"
 
+#define EQOS_LOOPBACK_TEST_FRAMES      8
+#define EQOS_LOOPBACK_TEST_FRAME_SIZE  256
+#define EQOS_LOOPBACK_TEST_ETHER_TYPE  0x88B5    // IEEE local experimental
+#define EQOS_LOOPBACK_TEST_TIMEOUT     100       // ms
+
 /**
   Changes the state of a network interface from "stopped" to "started".
 
@@ -40,7 +45,8 @@ EqosSnpStart (
     return EFI_DEVICE_ERROR;
   }
 
-  Eqos->SnpMode.State = EfiSimpleNetworkStarted;
+  Eqos->TxRecycledCount = 0;
+  Eqos->SnpMode.State   = EfiSimpleNetworkStarted;
 
   return EFI_SUCCESS;
 }
@@ -141,10 +147,165 @@ EqosSnpInitialize (
   return EFI_SUCCESS;
 }
 
+/**
+  Sends a burst of frames with the MAC in internal loopback mode and checks
+  that all of them are received back intact, exercising the TX and RX rings
+  without needing a link partner.
+
+  The rings are restarted afterwards. Buffers the caller queued for transmit
+  are drained by EqosStop() and remain available through GetStatus(); only
+  the test frames are taken off the recycle list.
+
+  @param  Eqos  The driver instance.
+
+  @retval EFI_SUCCESS           All frames were looped back correctly.
+  @retval EFI_OUT_OF_RESOURCES  The test frames could not be allocated.
+  @retval EFI_DEVICE_ERROR      Some frames were lost or corrupted.
+
+**/
+STATIC
+EFI_STATUS
+EqosLoopbackSelfTest (
+  IN EQOS_PRIVATE_DATA  *Eqos
+  )
+{
+  EFI_STATUS                   Status;
+  EFI_SIMPLE_NETWORK_PROTOCOL  *Snp;
+  UINT8                        *TxFrames;
+  UINT8                        *Frame;
+  UINT8                        RxFrame[MAX_ETHERNET_FRAME_SIZE];
+  UINTN                        RxSize;
+  UINT32                       Sent;
+  UINT32                       Received;
+  UINT32                       Errors;
+  UINT32                       Retry;
+  UINT32                       Index;
+  UINT32                       Kept;
+
+  Snp = &Eqos->Snp;
+
+  TxFrames = AllocatePool (EQOS_LOOPBACK_TEST_FRAMES * EQOS_LOOPBACK_TEST_FRAME_SIZE);
+  if (TxFrames == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  for (Sent = 0; Sent < EQOS_LOOPBACK_TEST_FRAMES; Sent++) {
+    Frame = TxFrames + Sent * EQOS_LOOPBACK_TEST_FRAME_SIZE;
+    CopyMem (&Frame[0], &Eqos->SnpMode.CurrentAddress, NET_ETHER_ADDR_LEN);
+    CopyMem (&Frame[6], &Eqos->SnpMode.CurrentAddress, NET_ETHER_ADDR_LEN);
+    Frame[12] = (EQOS_LOOPBACK_TEST_ETHER_TYPE & 0xFF00) >> 8;
+    Frame[13] = EQOS_LOOPBACK_TEST_ETHER_TYPE & 0xFF;
+    for (Index = 14; Index < EQOS_LOOPBACK_TEST_FRAME_SIZE; Index++) {
+      Frame[Index] = (UINT8)(Index + Sent);
+    }
+  }
+
+  EqosSetLoopback (Eqos, TRUE);
+
+  for (Sent = 0; Sent < EQOS_LOOPBACK_TEST_FRAMES; Sent++) {
+    Status = Snp->Transmit (
+                    Snp,
+                    0,
+                    EQOS_LOOPBACK_TEST_FRAME_SIZE,
+                    TxFrames + Sent * EQOS_LOOPBACK_TEST_FRAME_SIZE,
+                    NULL,
+                    NULL,
+                    NULL
+                    );
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+  }
+
+  Received = 0;
+  Errors   = 0;
+  for (Retry = EQOS_LOOPBACK_TEST_TIMEOUT * 10; (Retry > 0) && (Received < Sent); Retry--) {
+    //
+    // Reclaim without popping, so that buffers belonging to the caller
+    // stay on the recycle list.
+    //
+    EqosReclaimTxDescriptors (Eqos);
+
+    RxSize = sizeof (RxFrame);
+    Status = Snp->Receive (Snp, NULL, &RxSize, RxFrame, NULL, NULL, NULL);
+    if (Status == EFI_NOT_READY) {
+      gBS->Stall (100);
+      continue;
+    }
+
+    //
+    // The received length includes the FCS, which is not stripped.
+    //
+    if (EFI_ERROR (Status) ||
+        (RxSize < EQOS_LOOPBACK_TEST_FRAME_SIZE) ||
+        (CompareMem (
+           RxFrame,
+           TxFrames + Received * EQOS_LOOPBACK_TEST_FRAME_SIZE,
+           EQOS_LOOPBACK_TEST_FRAME_SIZE
+           ) != 0))
+    {
+      Errors++;
+    }
+
+    Received++;
+  }
+
+  EqosSetLoopback (Eqos, FALSE);
+
+  DEBUG ((
+    (Received == EQOS_LOOPBACK_TEST_FRAMES && Errors == 0) ? DEBUG_INFO : DEBUG_ERROR,
+    "%a: Sent %u, received %u, corrupted %u of %u frames\n",
+    __func__,
+    Sent,
+    Received,
+    Errors,
+    EQOS_LOOPBACK_TEST_FRAMES
+    ));
+
+  if ((Received != EQOS_LOOPBACK_TEST_FRAMES) || (Errors != 0)) {
+    Status = EFI_DEVICE_ERROR;
+  } else {
+    Status = EFI_SUCCESS;
+  }
+
+  //
+  // Restart the rings so that no test frame is left in flight, then drop
+  // the test frames from the recycle list before they are freed.
+  //
+  EqosStop (Eqos);
+
+  Kept = 0;
+  for (Index = 0; Index < Eqos->TxRecycledCount; Index++) {
+    Frame = Eqos->TxRecycled[Index];
+    if ((Frame >= TxFrames) &&
+        (Frame < TxFrames + EQOS_LOOPBACK_TEST_FRAMES * EQOS_LOOPBACK_TEST_FRAME_SIZE))
+    {
+      continue;
+    }
+
+    Eqos->TxRecycled[Kept++] = Frame;
+  }
+
+  Eqos->TxRecycledCount = Kept;
+
+  FreePool (TxFrames);
+
+  if (!EFI_ERROR (Status)) {
+    Status = EqosStart (Eqos);
+  } else {
+    EqosStart (Eqos);
+  }
+
+  return Status;
+}
+
 /**
   Resets a network adapter and re-initializes it with the parameters that were
   provided in the previous call to Initialize().
 
+  If ExtendedVerification is TRUE, a loopback self-test of the MAC and its
+  DMA rings is performed as part of the reset.
+
   @param  This                 The protocol instance pointer.
   @param  ExtendedVerification Indicates that the driver may perform a more
                                exhaustive verification operation of the device
@@ -191,6 +352,13 @@ EqosSnpReset (
     return Status;
   }
 
+  if (ExtendedVerification) {
+    Status = EqosLoopbackSelfTest (Eqos);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
   Status = EqosSetRxFilters (
              Eqos,
              Eqos->SnpMode.ReceiveFilterSetting,
@@ -428,7 +596,49 @@ EqosSnpStatistics (
   OUT EFI_NETWORK_STATISTICS       *StatisticsTable OPTIONAL
   )
 {
-  return EFI_UNSUPPORTED;
+  EQOS_PRIVATE_DATA  *Eqos;
+  EFI_STATUS         Status;
+
+  if ((This == NULL) || (!Reset && (StatisticsSize == NULL)) ||
+      ((StatisticsSize != NULL) && (*StatisticsSize != 0) && (StatisticsTable == NULL)))
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Eqos = EQOS_PRIVATE_DATA_FROM_SNP_THIS (This);
+  if (Eqos->SnpMode.State == EfiSimpleNetworkStopped) {
+    return EFI_NOT_STARTED;
+  }
+
+  if (Eqos->SnpMode.State != EfiSimpleNetworkInitialized) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  EqosUpdateRxDropStatistics (Eqos);
+
+  Status = EFI_SUCCESS;
+
+  if (StatisticsSize != NULL) {
+    if (*StatisticsSize < sizeof (EFI_NETWORK_STATISTICS)) {
+      Status = EFI_BUFFER_TOO_SMALL;
+    }
+
+    if (StatisticsTable != NULL) {
+      CopyMem (
+        StatisticsTable,
+        &Eqos->Stats,
+        MIN (*StatisticsSize, sizeof (EFI_NETWORK_STATISTICS))
+        );
+    }
+
+    *StatisticsSize = sizeof (EFI_NETWORK_STATISTICS);
+  }
+
+  if (Reset) {
+    EqosResetStatistics (Eqos);
+  }
+
+  return Status;
 }
 
 /**
@@ -585,8 +795,6 @@ EqosSnpGetStatus (
   )
 {
   EQOS_PRIVATE_DATA  *Eqos;
-  EFI_STATUS         Status;
-  UINT32             DescIndex;
 
   if (This == NULL) {
     return EFI_INVALID_PARAMETER;
@@ -606,22 +814,15 @@ EqosSnpGetStatus (
   if (TxBuf != NULL) {
     *TxBuf = NULL;
 
-    if (Eqos->TxQueued > 0) {
-      DescIndex = Eqos->TxCurrent;
+    EqosReclaimTxDescriptors (Eqos);
 
-      Status = EqosCheckTxDescriptor (Eqos, DescIndex);
-      if (Status != EFI_NOT_READY) {
-        ASSERT (Eqos->TxBuffersMap[DescIndex] != NULL);
-        EqosDmaUnmapTxDescriptor (Eqos, DescIndex);
-
-        *TxBuf = Eqos->TxBuffers[DescIndex];
-
-        Eqos->TxCurrent = EQOS_TX_NEXT (DescIndex);
-        Eqos->TxQueued--;
-      }
+    if (Eqos->TxRecycledCount > 0) {
+      *TxBuf = Eqos->TxRecycled[--Eqos->TxRecycledCount];
     }
   }
 
+  EqosUpdateRxDropStatistics (Eqos);
+
   //
   // InterruptStatus is not currently consumed by the upper layers,
   // but we still read it for compliance and to log any detected
@@ -724,7 +925,11 @@ EqosSnpTransmit (
     return EFI_ACCESS_DENIED;
   }
 
-  if (Eqos->TxQueued == EQOS_TX_DESC_COUNT - 1) {
+  //
+  // Buffers waiting to be recycled count against the ring too, so that
+  // the recycled buffer array can never overflow.
+  //
+  if (Eqos->TxQueued + Eqos->TxRecycledCount >= EQOS_TX_DESC_COUNT - 1) {
     Status = EFI_NOT_READY;
     goto Exit;
   }
@@ -744,12 +949,16 @@ EqosSnpTransmit (
 
   Status = EqosDmaMapTxDescriptor (Eqos, DescIndex, BufferSize);
   if (EFI_ERROR (Status)) {
+    Eqos->Stats.TxDroppedFrames++;
     goto Exit;
   }
 
   Eqos->TxNext = EQOS_TX_NEXT (DescIndex);
   Eqos->TxQueued++;
 
+  Eqos->Stats.TxTotalFrames++;
+  Eqos->Stats.TxTotalBytes += BufferSize;
+
   Status = EFI_SUCCESS;
 
 Exit:
@@ -803,7 +1012,6 @@ EqosSnpReceive (
 {
   EQOS_PRIVATE_DATA  *Eqos;
   EFI_STATUS         Status;
-  EFI_STATUS         MapStatus;
   UINT32             DescIndex;
   UINT8              *Frame;
   UINTN              FrameLength;
@@ -834,8 +1042,6 @@ EqosSnpReceive (
   if (Status == EFI_NOT_READY) {
     goto Exit;
   } else if (EFI_ERROR (Status)) {
-    ASSERT (Eqos->RxBuffersMap[DescIndex] != NULL);
-    EqosDmaUnmapRxDescriptor (Eqos, DescIndex);
     goto ReleaseDesc;
   }
 
@@ -852,11 +1058,21 @@ EqosSnpReceive (
     goto Exit;
   }
 
-  ASSERT (Eqos->RxBuffersMap[DescIndex] != NULL);
-  EqosDmaUnmapRxDescriptor (Eqos, DescIndex);
+  EqosDmaSyncRxDescriptor (Eqos, DescIndex, FrameLength);
 
   Frame = EQOS_RX_BUFFER (Eqos, DescIndex);
 
+  Eqos->Stats.RxTotalFrames++;
+  Eqos->Stats.RxGoodFrames++;
+  Eqos->Stats.RxTotalBytes += FrameLength;
+  if ((Frame[0] & BIT0) == 0) {
+    Eqos->Stats.RxUnicastFrames++;
+  } else if (CompareMem (Frame, &Eqos->SnpMode.BroadcastAddress, NET_ETHER_ADDR_LEN) == 0) {
+    Eqos->Stats.RxBroadcastFrames++;
+  } else {
+    Eqos->Stats.RxMulticastFrames++;
+  }
+
   if (DestAddr != NULL) {
     CopyMem (&DestAddr->Addr[0], &Frame[0], NET_ETHER_ADDR_LEN);
   }
@@ -879,11 +1095,7 @@ EqosSnpReceive (
   Status = EFI_SUCCESS;
 
 ReleaseDesc:
-  MapStatus = EqosDmaMapRxDescriptor (Eqos, DescIndex);
-  if (EFI_ERROR (MapStatus)) {
-    Status = MapStatus;
-    goto Exit;
-  }
+  EqosDmaMapRxDescriptor (Eqos, DescIndex);
 
   Eqos->RxCurrent = EQOS_RX_NEXT (Eqos->RxCurrent);
 
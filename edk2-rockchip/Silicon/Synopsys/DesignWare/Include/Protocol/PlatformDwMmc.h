@@ -43,6 +43,11 @@ typedef struct {
   EFI_HANDLE    Controller;
 } DW_MMC_HC_SLOT_CAP;
 
+typedef enum {
+  DwMmcDrivePhase,
+  DwMmcSamplePhase
+} DW_MMC_CLOCK_PHASE_TYPE;
+
 //
 // Protocol interface structure
 //
@@ -63,9 +68,23 @@ BOOLEAN
   IN UINT8                      Slot
   );
 
+//
+// Optional: set the drive or sample clock phase (in degrees) of the card
+// clock. Used for SDR50/SDR104 tuning; may be NULL if not supported.
+//
+typedef
+EFI_STATUS
+(EFIAPI *PLATFORM_DW_MMC_SET_CLOCK_PHASE)(
+  IN EFI_HANDLE                 Controller,
+  IN UINT8                      Slot,
+  IN DW_MMC_CLOCK_PHASE_TYPE    Type,
+  IN UINT32                     Degrees
+  );
+
 struct _PLATFORM_DW_MMC_PROTOCOL {
-  PLATFORM_DW_MMC_GET_CAPABILITY    GetCapability;
-  PLATFORM_DW_MMC_CARD_DETECT       CardDetect;
+  PLATFORM_DW_MMC_GET_CAPABILITY     GetCapability;
+  PLATFORM_DW_MMC_CARD_DETECT        CardDetect;
+  PLATFORM_DW_MMC_SET_CLOCK_PHASE    SetClockPhase;
 };
 
 extern EFI_GUID  gPlatformDwMmcProtocolGuid;